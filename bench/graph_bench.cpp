@@ -0,0 +1,479 @@
+// nged_bench: times the document model on synthetic graphs
+//
+// usage: nged_bench [--shapes=chain,fan,dag,router,nested] [--sizes=1000,10000,100000]
+//                   [--repeat=3] [--budget=10000] [--skip=fan.traverse,dag.traverse]
+//                   [--out=results.jsonl] [--tmp=dir]
+//
+// every measurement is written as one JSON object per line, e.g.
+//   {"shape":"chain","size":1000,"items":1999,"op":"setLink","run":0,"ms":1.23}
+// so runs can be diffed / plotted for regression tracking; a summary goes to stderr.
+// once a shape takes longer than `--budget` ms for one run, its larger sizes are skipped
+// (recorded with op "skipped"), some operations are still quadratic on some shapes.
+// `--skip` lists shape.op pairs that are not run at all; by default the bottom-up traverse
+// of fans and random DAGs, which revisits shared upstream once per path
+#include <nged/ngdoc.h>
+#include <nged/utils.h>
+
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+
+using namespace nged;
+using msghub = MessageHub;
+
+// Nodes & Factory {{{
+class BenchNode : public Node
+{
+  sint numInputs_;
+  sint numOutputs_;
+
+public:
+  BenchNode(Graph* parent, String type, sint numInputs, sint numOutputs)
+      : Node(parent, type, type), numInputs_(numInputs), numOutputs_(numOutputs)
+  {
+  }
+  sint numMaxInputs() const override { return numInputs_; }
+  sint numOutputs() const override { return numOutputs_; }
+};
+
+class BenchSubgraphNode : public BenchNode
+{
+  GraphPtr subgraph_;
+
+public:
+  BenchSubgraphNode(Graph* parent) : BenchNode(parent, "subgraph", 1, 1)
+  {
+    subgraph_ = std::make_shared<Graph>(parent->docRoot(), parent, "subgraph");
+  }
+  Graph*       asGraph() override { return subgraph_.get(); }
+  Graph const* asGraph() const override { return subgraph_.get(); }
+
+  bool serialize(Json& json) const override
+  {
+    return Node::serialize(json) && subgraph_->serialize(json["subgraph"]);
+  }
+  bool deserialize(Json const& json) override
+  {
+    return Node::deserialize(json) && subgraph_->deserialize(json.at("subgraph"));
+  }
+};
+
+class BenchNodeFactory : public NodeFactory
+{
+public:
+  GraphPtr createRootGraph(NodeGraphDoc* doc) const override
+  {
+    return std::make_shared<Graph>(doc, nullptr, "root");
+  }
+  NodePtr createNode(Graph* parent, StringView type) const override
+  {
+    if (type == "subgraph")
+      return std::make_shared<BenchSubgraphNode>(parent);
+    if (type == "merge")
+      return std::make_shared<BenchNode>(parent, "merge", -1, 1);
+    if (type == "split")
+      return std::make_shared<BenchNode>(parent, "split", 1, 4);
+    if (type == "exec")
+      return std::make_shared<BenchNode>(parent, "exec", 4, 1);
+    return std::make_shared<BenchNode>(parent, String(type), 1, 1);
+  }
+  void listNodeTypes(
+    Graph* graph,
+    void*  context,
+    void (*ret)(void* context, StringView category, StringView type, StringView name))
+    const override
+  {
+    for (auto type : {"null", "exec", "merge", "split", "subgraph"})
+      ret(context, "bench", type, type);
+  }
+};
+// }}} Nodes & Factory
+
+// Generators {{{
+/// a synthetic graph is described as node types and links between them, so that the same
+/// shape can be built item by item (timing `add` and `setLink` separately)
+struct Shape
+{
+  struct Link
+  {
+    size_t src;
+    sint   srcPort;
+    size_t dst;
+    sint   dstPort; // -1: next free input of a variadic node
+  };
+  Vector<String> types;
+  Vector<Vec2>   positions;
+  Vector<Link>   links;
+  Vector<size_t> sinks; // start points for bottom-up traversal
+};
+
+static Vec2 gridPos(size_t i, size_t columns = 256)
+{
+  return Vec2(float(i % columns) * 80.f, float(i / columns) * 60.f);
+}
+
+static Shape makeChain(size_t n)
+{
+  Shape shape;
+  for (size_t i = 0; i < n; ++i) {
+    shape.types.push_back("null");
+    shape.positions.push_back(gridPos(i));
+    if (i > 0)
+      shape.links.push_back({i - 1, 0, i, 0});
+  }
+  shape.sinks.push_back(n - 1);
+  return shape;
+}
+
+// blocks of: split -> `width` nulls -> merge, each block fed by the previous merge
+static Shape makeFan(size_t n, size_t width = 256)
+{
+  Shape  shape;
+  size_t prevMerge = size_t(-1);
+  while (shape.types.size() < n) {
+    size_t const w     = std::max<size_t>(1, std::min(width, n - shape.types.size()));
+    size_t const split = shape.types.size();
+    shape.types.push_back("split");
+    if (prevMerge != size_t(-1))
+      shape.links.push_back({prevMerge, 0, split, 0});
+    for (size_t i = 0; i < w; ++i) {
+      shape.types.push_back("null");
+      shape.links.push_back({split, sint(i % 4), split + 1 + i, 0});
+    }
+    size_t const merge = shape.types.size();
+    shape.types.push_back("merge");
+    for (size_t i = 0; i < w; ++i)
+      shape.links.push_back({split + 1 + i, 0, merge, -1});
+    prevMerge = merge;
+  }
+  for (size_t i = 0; i < shape.types.size(); ++i)
+    shape.positions.push_back(gridPos(i, 258));
+  shape.sinks.push_back(prevMerge);
+  return shape;
+}
+
+// every node takes up to 4 inputs from random earlier nodes, mostly near ones
+static Shape makeRandomDAG(size_t n, uint32_t seed = 42)
+{
+  Shape        shape;
+  std::mt19937 rng(seed);
+  for (size_t i = 0; i < n; ++i) {
+    shape.types.push_back("exec");
+    shape.positions.push_back(gridPos(i));
+    if (i == 0)
+      continue;
+    std::geometric_distribution<size_t> distance(0.05);
+    for (size_t port = 0, numInputs = rng() % 5; port < numInputs; ++port)
+      shape.links.push_back({i - 1 - std::min(i - 1, distance(rng)), 0, i, sint(port)});
+  }
+  for (size_t i = n > 16 ? n - 16 : 0; i < n; ++i)
+    shape.sinks.push_back(i);
+  return shape;
+}
+
+// a chain where every hop passes through `hops` routers
+static Shape makeRouterChain(size_t n, size_t hops = 3)
+{
+  Shape  shape;
+  size_t prev = size_t(-1);
+  while (shape.types.size() < n) {
+    size_t const node = shape.types.size();
+    shape.types.push_back("null");
+    if (prev != size_t(-1)) {
+      size_t src = prev;
+      for (size_t h = 0; h < hops; ++h) {
+        shape.types.push_back("router");
+        shape.links.push_back({src, 0, shape.types.size() - 1, 0});
+        src = shape.types.size() - 1;
+      }
+      shape.links.push_back({src, 0, node, 0});
+    }
+    prev = node;
+  }
+  for (size_t i = 0; i < shape.types.size(); ++i)
+    shape.positions.push_back(gridPos(i));
+  shape.sinks.push_back(prev);
+  return shape;
+}
+
+static bool buildShape(
+  Graph*          graph,
+  Shape const&    shape,
+  Vector<ItemID>& ids,
+  double*         addMs  = nullptr,
+  double*         linkMs = nullptr);
+// }}} Generators
+
+// Timing {{{
+struct Record
+{
+  String shape;
+  size_t size;
+  size_t items;
+  String op;
+  int    run;
+  double ms;
+};
+
+class Stopwatch
+{
+  std::chrono::steady_clock::time_point start_ = std::chrono::steady_clock::now();
+
+public:
+  double ms() const
+  {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_)
+      .count();
+  }
+};
+
+template<class F>
+static double timeit(F&& func)
+{
+  Stopwatch watch;
+  func();
+  return watch.ms();
+}
+// }}} Timing
+
+static bool buildShape(
+  Graph*          graph,
+  Shape const&    shape,
+  Vector<ItemID>& ids,
+  double*         addMs,
+  double*         linkMs)
+{
+  auto* doc = graph->docRoot();
+  ids.clear();
+  ids.reserve(shape.types.size());
+  auto add = timeit([&] {
+    for (size_t i = 0; i < shape.types.size(); ++i) {
+      GraphItemPtr item;
+      if (shape.types[i] == "router")
+        item = doc->itemFactory()->make(graph, "router");
+      else
+        item = doc->nodeFactory()->createNode(graph, shape.types[i]);
+      item->moveTo(shape.positions[i]);
+      ids.push_back(graph->add(item));
+    }
+  });
+  auto link = timeit([&] {
+    for (auto const& l : shape.links)
+      graph->setLink(ids[l.src], l.srcPort, ids[l.dst], l.dstPort);
+  });
+  if (addMs)
+    *addMs = add;
+  if (linkMs)
+    *linkMs = link;
+  return std::find(ids.begin(), ids.end(), ID_None) == ids.end();
+}
+
+// nested subgraphs, `depth` levels, every level holds a chain and the next level's node
+static bool buildNested(Graph* root, size_t n, size_t depth, double* addMs, double* linkMs)
+{
+  size_t const perLevel = std::max<size_t>(2, n / depth);
+  Graph*       graph    = root;
+  *addMs = *linkMs = 0;
+  for (size_t level = 0; level < depth && graph; ++level) {
+    Vector<ItemID> ids;
+    double         add = 0, link = 0;
+    if (!buildShape(graph, makeChain(perLevel), ids, &add, &link))
+      return false;
+    Graph* next = nullptr;
+    add += timeit([&] {
+      if (level + 1 < depth)
+        if (auto sub = graph->createNode("subgraph"))
+          next = sub->asGraph();
+    });
+    *addMs += add;
+    *linkMs += link;
+    graph = next;
+  }
+  return true;
+}
+
+static double runShape(
+  String const&                       name,
+  size_t                              size,
+  int                                 run,
+  String const&                       tmpdir,
+  HashSet<String> const&              skip,
+  std::function<void(Record const&)> const& emit)
+{
+  Stopwatch total;
+  auto itemFactory = defaultGraphItemFactory();
+  auto factory     = std::make_shared<BenchNodeFactory>();
+  auto doc         = std::make_shared<NodeGraphDoc>(factory, itemFactory.get());
+  doc->makeRoot();
+  doc->history().reset(true);
+  auto graph = doc->root();
+
+  auto record = [&](String op, double ms) {
+    emit({name, size, doc->numItems(), std::move(op), run, ms});
+  };
+
+  double         addMs = 0, linkMs = 0;
+  Vector<ItemID> sinks;
+  if (name == "nested") {
+    if (!buildNested(graph.get(), size, 16, &addMs, &linkMs)) {
+      msghub::errorf("failed to build {} x {}", name, size);
+      return total.ms();
+    }
+  } else {
+    Shape shape = name == "chain" ? makeChain(size)
+                  : name == "fan" ? makeFan(size)
+                  : name == "dag" ? makeRandomDAG(size)
+                                  : makeRouterChain(size);
+    Vector<ItemID> ids;
+    if (!buildShape(graph.get(), shape, ids, &addMs, &linkMs)) {
+      msghub::errorf("failed to build {} x {}", name, size);
+      return total.ms();
+    }
+    for (auto i : shape.sinks)
+      sinks.push_back(ids[i]);
+  }
+  record("add", addMs);
+  record("setLink", linkMs);
+
+  HashSet<ItemID> all(graph->items().begin(), graph->items().end());
+  record("move", timeit([&] { graph->move(all, Vec2(10, 10)); }));
+
+  if (!sinks.empty() && !skip.count(name + ".traverse")) {
+    GraphTraverseResult result;
+    record("traverse", timeit([&] { graph->traverse(result, sinks, false); }));
+  }
+
+  record("commit", timeit([&] { doc->history().commit("bench move"); }));
+  graph->move(all, Vec2(-10, -10));
+  doc->history().commit("bench move back");
+  record("undo", timeit([&] { doc->undo(); }));
+  graph = doc->root(); // checkout may replace the content, not the root
+
+  Json json;
+  record("serialize", timeit([&] { doc->serializeGraph(graph.get(), json); }));
+  {
+    auto copy = std::make_shared<NodeGraphDoc>(factory, itemFactory.get());
+    copy->makeRoot();
+    record("deserialize", timeit([&] { copy->deserializeGraph(copy->root().get(), json); }));
+  }
+
+  auto path = (std::filesystem::path(tmpdir) / fmt::format("nged_bench_{}_{}.json", name, size))
+                .string();
+  record("saveTo", timeit([&] { doc->saveTo(path); }));
+  {
+    auto loaded = std::make_shared<NodeGraphDoc>(factory, itemFactory.get());
+    loaded->makeRoot();
+    record("open", timeit([&] { loaded->open(path); }));
+  }
+  std::error_code ec;
+  std::filesystem::remove(path, ec);
+
+  all = HashSet<ItemID>(graph->items().begin(), graph->items().end());
+  record("remove", timeit([&] { graph->remove(all); }));
+  return total.ms();
+}
+
+static Vector<String> splitList(StringView arg)
+{
+  Vector<String> result;
+  for (auto part : utils::strsplit(arg, ","))
+    if (!part.empty())
+      result.emplace_back(part);
+  return result;
+}
+
+int main(int argc, char** argv)
+{
+  Vector<String> shapes = {"chain", "fan", "dag", "router", "nested"};
+  Vector<size_t> sizes  = {1000, 10000, 100000};
+  int            repeat = 3;
+  double         budget = 10000;
+  Vector<String> skip   = {"fan.traverse", "dag.traverse"};
+  String         out    = "";
+  String         tmpdir = std::filesystem::temp_directory_path().string();
+
+  for (int i = 1; i < argc; ++i) {
+    StringView arg = argv[i];
+    auto       eq  = arg.find('=');
+    auto       key = arg.substr(0, eq);
+    auto       val = eq == StringView::npos ? StringView() : arg.substr(eq + 1);
+    if (key == "--shapes")
+      shapes = splitList(val);
+    else if (key == "--sizes") {
+      sizes.clear();
+      for (auto const& s : splitList(val))
+        sizes.push_back(std::stoull(s));
+    } else if (key == "--repeat")
+      repeat = std::max(1, std::stoi(String(val)));
+    else if (key == "--budget")
+      budget = std::stod(String(val));
+    else if (key == "--skip")
+      skip = splitList(val);
+    else if (key == "--out")
+      out = String(val);
+    else if (key == "--tmp")
+      tmpdir = String(val);
+    else {
+      std::cerr << "usage: " << argv[0]
+                << " [--shapes=chain,fan,dag,router,nested] [--sizes=1000,10000,100000]"
+                   " [--repeat=3] [--budget=10000] [--skip=fan.traverse,dag.traverse]"
+                   " [--out=results.jsonl] [--tmp=dir]\n";
+      return arg == "--help" || arg == "-h" ? 0 : 1;
+    }
+  }
+
+  // setLink & co. trace every call, which would be what we measure otherwise
+  spdlog::set_level(spdlog::level::warn);
+  MessageHub::instance().setMinVerbosity(MessageHub::Verbosity::Warning);
+
+  std::ofstream outfile;
+  if (!out.empty()) {
+    outfile.open(out);
+    if (!outfile.good()) {
+      std::cerr << "cannot open " << out << " for writing\n";
+      return 1;
+    }
+  }
+  std::ostream& os = out.empty() ? std::cout : outfile;
+
+  auto emit = [&os](Record const& r) {
+    Json line = {
+      {"shape", r.shape},
+      {"size", r.size},
+      {"items", r.items},
+      {"op", r.op},
+      {"run", r.run},
+      {"ms", r.ms}};
+    os << line.dump() << std::endl; // partial results survive an interrupted run
+    std::cerr << fmt::format(
+      "{:>8} {:>8} {:>12} run {} {:>10.3f} ms\n", r.shape, r.size, r.op, r.run, r.ms);
+  };
+  HashSet<String> const skipOps(skip.begin(), skip.end());
+  for (auto const& shape : shapes) {
+    if (shape != "chain" && shape != "fan" && shape != "dag" && shape != "router" &&
+        shape != "nested") {
+      std::cerr << "unknown shape " << shape << '\n';
+      return 1;
+    }
+    bool overBudget = false;
+    for (auto size : sizes) {
+      for (int run = 0; run < repeat && !overBudget; ++run)
+        overBudget = runShape(shape, size, run, tmpdir, skipOps, emit) > budget;
+      if (overBudget && size != sizes.back()) {
+        std::cerr << shape << " is over budget, skipping larger sizes\n";
+        for (auto skipped : sizes)
+          if (skipped > size)
+            emit({shape, skipped, 0, "skipped", 0, 0});
+        break;
+      }
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,181 @@
+// nged_parmbench: per-node memory and load time of parmscript parms
+//
+// usage: nged_parmbench [--sizes=1000,10000] [--items=4] [--repeat=3] [--out=results.jsonl]
+//
+// every size loads that many ParmSets from the same script, like a document with as many
+// nodes of one type, and resizes their list to `--items` entries. one JSON object per line:
+//   {"bench":"parm","instances":1000,"op":"load","run":0,"ms":1.23}
+//   {"bench":"parm","instances":1000,"op":"memory","parms":25000,"definitions":12001,
+//    "sharedBytes":1234,"unsharedBytes":5678,"valueBytes":910}
+// `sharedBytes` is what the definitions cost as they are shared now, `unsharedBytes` what they
+// would cost with one definition per parm, both approximate the heap used by their strings,
+// meta and menu items. `valueBytes` is the part that is per parm either way
+#include <parmscript.h>
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using parmscript::Parm;
+using parmscript::ParmSet;
+using Json = nlohmann::json;
+
+// same kinds of parms a typical python node declares
+static char const* const benchScript = R"(
+toggle "enabled" {default=true}
+int "count" {default=3, min=0, max=10}
+float "scale" {default=0.5, disablewhen="{count} > 5"}
+float3 "offset" {default={1,2,3}}
+text "name" {default="hello", font="mono"}
+menu "mode" {items={"add", "sub", "mul"}, default="sub"}
+struct "transform"
+  float2 "translate" {default={0,0}}
+  float "rotate" {min=-180, max=180}
+endstruct "transform"
+list "points" {default=2}
+  text "tag"
+  int2 "xy"
+endlist "points"
+)";
+
+// Measurement {{{
+static size_t stringBytes(std::string const& s)
+{
+  return s.capacity() > std::string().capacity() ? s.capacity() + 1 : 0;
+}
+
+static size_t definitionBytes(Parm::Definition const& def)
+{
+  size_t bytes = sizeof(def) + stringBytes(def.name) + stringBytes(def.path) + stringBytes(def.label);
+  for (auto const& [key, value] : def.meta)
+    bytes += sizeof(key) + sizeof(value) + stringBytes(key);
+  bytes += def.menu_values.capacity() * sizeof(int);
+  for (auto const& item : def.menu_items)
+    bytes += sizeof(item) + stringBytes(item);
+  for (auto const& label : def.menu_labels)
+    bytes += sizeof(label) + stringBytes(label);
+  return bytes;
+}
+
+struct Footprint
+{
+  size_t                            parms         = 0;
+  size_t                            unsharedBytes = 0;
+  size_t                            sharedBytes   = 0;
+  size_t                            valueBytes    = 0;
+  std::set<Parm::Definition const*> definitions;
+};
+
+// every parm, list items included, against the distinct definitions they point to
+static void measure(Footprint& fp, Parm& parm)
+{
+  ++fp.parms;
+  auto const& def   = *parm.definition();
+  auto const  bytes = definitionBytes(def);
+  fp.unsharedBytes += bytes;
+  if (fp.definitions.insert(&def).second)
+    fp.sharedBytes += bytes;
+  fp.valueBytes += sizeof(Parm) + sizeof(std::shared_ptr<Parm>);
+  for (auto const& field : parm.allFields())
+    measure(fp, *field);
+  for (size_t i = 0, n = parm.numListValues(); i < n; ++i)
+    measure(fp, *parm.getListStruct(i));
+}
+// }}} Measurement
+
+static std::vector<size_t> splitSizes(std::string_view arg)
+{
+  std::vector<size_t> result;
+  while (!arg.empty()) {
+    auto comma = arg.find(',');
+    auto part  = arg.substr(0, comma);
+    if (!part.empty())
+      result.push_back(std::stoull(std::string(part)));
+    arg = comma == std::string_view::npos ? std::string_view() : arg.substr(comma + 1);
+  }
+  return result;
+}
+
+int main(int argc, char** argv)
+{
+  std::vector<size_t> sizes  = {1000, 10000};
+  size_t              items  = 4;
+  int                 repeat = 3;
+  std::string         out    = "";
+
+  for (int i = 1; i < argc; ++i) {
+    std::string_view arg = argv[i];
+    auto             eq  = arg.find('=');
+    auto             key = arg.substr(0, eq);
+    auto             val = eq == std::string_view::npos ? std::string_view() : arg.substr(eq + 1);
+    if (key == "--sizes")
+      sizes = splitSizes(val);
+    else if (key == "--items")
+      items = std::stoull(std::string(val));
+    else if (key == "--repeat")
+      repeat = std::max(1, std::stoi(std::string(val)));
+    else if (key == "--out")
+      out = std::string(val);
+    else {
+      std::cerr << "usage: " << argv[0]
+                << " [--sizes=1000,10000] [--items=4] [--repeat=3] [--out=results.jsonl]\n";
+      return arg == "--help" || arg == "-h" ? 0 : 1;
+    }
+  }
+
+  std::ofstream outfile;
+  if (!out.empty()) {
+    outfile.open(out);
+    if (!outfile.good()) {
+      std::cerr << "cannot open " << out << " for writing\n";
+      return 1;
+    }
+  }
+  std::ostream& os = out.empty() ? std::cout : outfile;
+
+  for (auto size : sizes) {
+    std::vector<std::unique_ptr<ParmSet>> instances;
+    for (int run = 0; run < repeat; ++run) {
+      instances.clear();
+      instances.reserve(size);
+      auto start = std::chrono::steady_clock::now();
+      for (size_t i = 0; i < size; ++i) {
+        instances.push_back(std::make_unique<ParmSet>());
+        instances.back()->loadScript(benchScript);
+        instances.back()->get("points")->resizeList(items);
+      }
+      std::chrono::duration<double, std::milli> dt = std::chrono::steady_clock::now() - start;
+      os << Json{{"bench", "parm"}, {"instances", size}, {"op", "load"}, {"run", run}, {"ms", dt.count()}}.dump()
+         << std::endl;
+      std::cerr << "parm " << size << " load run " << run << ' ' << dt.count() << " ms\n";
+    }
+
+    Footprint fp;
+    for (auto const& ps : instances)
+      measure(fp, *ps->get(""));
+    os << Json{
+            {"bench", "parm"},
+            {"instances", size},
+            {"op", "memory"},
+            {"parms", fp.parms},
+            {"definitions", fp.definitions.size()},
+            {"sharedBytes", fp.sharedBytes},
+            {"unsharedBytes", fp.unsharedBytes},
+            {"valueBytes", fp.valueBytes}}
+            .dump()
+       << std::endl;
+    std::cerr << "parm " << size << ": " << fp.parms << " parms share " << fp.definitions.size()
+              << " definitions, " << fp.sharedBytes / size << " definition bytes per node vs "
+              << fp.unsharedBytes / size << " unshared, " << fp.valueBytes / size
+              << " value bytes per node\n";
+  }
+  return 0;
+}
@@ -0,0 +1,649 @@
+// nged_uibench: replays an input script against a headless ImGuiNodeGraphEditor and reports
+// per-frame CPU time of NetworkView::update() / draw() and of the whole frame
+//
+// usage: nged_uibench [--items=10000] [--doc=file] [--script=file] [--repeat=3]
+//                     [--size=1920x1080] [--per-frame] [--snapshot=file.png]
+//                     [--out=results.jsonl]
+//
+// there is no window and no GPU: ImGui runs with a null renderer that accepts textures and
+// drops draw lists, so every number is the CPU side of a frame. frames advance with a fixed
+// 1/60s step, so animations replay identically from run to run. `--snapshot` renders the
+// graph as it is after the script with RasterCanvas, to check what a script actually did.
+//
+// script format, one command per line, `#` starts a comment:
+//   phase <name>          frames from here on are reported under <name>
+//   frames <n>            n idle frames
+//   move <target> [n]     moves the mouse to target, interpolated over n frames (default 1)
+//   down|up <button>      left, right or middle; one frame
+//   click <button>        down and up; two frames
+//   wheel <dy> [n]        scrolls dy per frame, for n frames (default 1)
+//   key <chord>           e.g. ctrl+c, ctrl+v, del, esc, f; pressed for one frame
+//   zoom <scale>          sets the view scale directly, keeping the view center
+// targets are relative to the visible part of the network view, (0,0) is its top-left:
+//   <u>,<v>               a point
+//   node:<u>,<v>          the center of the visible node nearest to the point
+//   empty:<u>,<v>         the nearest spot to the point that has no item under it
+#include <nged/nged.h>
+#include <nged/nged_imgui.h>
+#include <nged/nged_raster.h>
+#include <nged/utils.h>
+
+#include <imgui.h>
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <sstream>
+
+using namespace nged;
+using msghub = MessageHub;
+
+static char const* const defaultScript = R"(
+phase warmup
+frames 10
+move 0.5,0.5
+click left
+frames 20
+
+phase overview
+frames 60
+
+phase pan
+zoom 1
+frames 5
+move empty:0.5,0.5
+down middle
+move 0.25,0.35 60
+move 0.6,0.6 60
+up middle
+
+phase zoom
+move 0.5,0.5
+wheel -1 30
+wheel 1 30
+
+phase box-select
+move empty:0.3,0.3
+down left
+move 0.7,0.7 60
+up left
+frames 5
+
+phase drag
+move node:0.5,0.5
+down left
+move 0.55,0.6 60
+up left
+frames 5
+
+phase copy-paste
+key ctrl+c
+move empty:0.6,0.4
+key ctrl+v
+frames 30
+
+phase idle
+frames 60
+)";
+
+// Document {{{
+class BenchNode : public Node
+{
+public:
+  BenchNode(Graph* parent, String type) : Node(parent, type, type) {}
+  sint numMaxInputs() const override { return 2; }
+  sint numOutputs() const override { return 1; }
+};
+
+class BenchNodeFactory : public NodeFactory
+{
+public:
+  GraphPtr createRootGraph(NodeGraphDoc* doc) const override
+  {
+    return std::make_shared<Graph>(doc, nullptr, "root");
+  }
+  NodePtr createNode(Graph* parent, StringView type) const override
+  {
+    return std::make_shared<BenchNode>(parent, String(type));
+  }
+  void listNodeTypes(
+    Graph* graph,
+    void*  context,
+    void (*ret)(void* context, StringView category, StringView type, StringView name))
+    const override
+  {
+    ret(context, "bench", "exec", "exec");
+  }
+};
+
+// a square grid, every node takes its left and upper neighbours as inputs
+static bool generateGrid(Graph* graph, size_t n)
+{
+  auto const columns = std::max<size_t>(1, size_t(std::ceil(std::sqrt(double(n)))));
+
+  Vector<String>          types(n, "exec");
+  Vector<Vec2>            positions;
+  Vector<Graph::BulkLink> links;
+  positions.reserve(n);
+  links.reserve(n * 2);
+  for (size_t i = 0; i < n; ++i) {
+    auto const x = i % columns, y = i / columns;
+    positions.push_back(Vec2(float(x) * 180.f, float(y) * 120.f));
+    if (x > 0)
+      links.push_back({sint(i - 1), 0, sint(i), 0});
+    if (y > 0)
+      links.push_back({sint(i - columns), 0, sint(i), 1});
+  }
+  Vector<ItemID> nodeIds, linkIds;
+  return graph->addBulk(types, positions, links, nodeIds, linkIds);
+}
+// }}} Document
+
+// Null Renderer {{{
+static void initNullRenderer()
+{
+  auto& io               = ImGui::GetIO();
+  io.BackendRendererName = "nged_uibench_null";
+#if IMGUI_VERSION_NUM >= 19200
+  io.BackendFlags |= ImGuiBackendFlags_RendererHasTextures;
+#else
+  unsigned char* pixels = nullptr;
+  int            width = 0, height = 0;
+  io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+  io.Fonts->SetTexID(ImTextureID(1));
+#endif
+}
+
+static void renderNull(ImDrawData* data)
+{
+#if IMGUI_VERSION_NUM >= 19200
+  if (data->Textures) {
+    for (ImTextureData* tex : *data->Textures) {
+      if (tex->Status == ImTextureStatus_WantCreate || tex->Status == ImTextureStatus_WantUpdates) {
+        tex->SetTexID(ImTextureID(1));
+        tex->SetStatus(ImTextureStatus_OK);
+      } else if (tex->Status == ImTextureStatus_WantDestroy) {
+        tex->SetTexID(ImTextureID_Invalid);
+        tex->SetStatus(ImTextureStatus_Destroyed);
+      }
+    }
+  }
+#else
+  (void)data;
+#endif
+}
+// }}} Null Renderer
+
+// Script {{{
+struct Command
+{
+  String         op;
+  Vector<String> args;
+  int            line = 0;
+};
+
+static Vector<Command> parseScript(StringView text)
+{
+  Vector<Command> commands;
+  int             lineno = 0;
+  for (auto line : utils::strsplit(text, "\n")) {
+    ++lineno;
+    if (auto comment = line.find('#'); comment != StringView::npos)
+      line = line.substr(0, comment);
+    std::istringstream words{String(line)};
+    Command            cmd;
+    if (!(words >> cmd.op))
+      continue;
+    for (String arg; words >> arg;)
+      cmd.args.push_back(arg);
+    cmd.line = lineno;
+    commands.push_back(std::move(cmd));
+  }
+  return commands;
+}
+
+static bool parseButton(StringView name, ImGuiMouseButton& button)
+{
+  if (name == "left")
+    button = ImGuiMouseButton_Left;
+  else if (name == "right")
+    button = ImGuiMouseButton_Right;
+  else if (name == "middle")
+    button = ImGuiMouseButton_Middle;
+  else
+    return false;
+  return true;
+}
+
+static bool parseChord(StringView chord, ImGuiKeyChord& mods, ImGuiKey& key)
+{
+  mods = ImGuiMod_None;
+  key  = ImGuiKey_None;
+  for (auto part : utils::strsplit(chord, "+")) {
+    if (part == "ctrl")
+      mods |= ImGuiMod_Ctrl;
+    else if (part == "shift")
+      mods |= ImGuiMod_Shift;
+    else if (part == "alt")
+      mods |= ImGuiMod_Alt;
+    else if (part == "del" || part == "delete")
+      key = ImGuiKey_Delete;
+    else if (part == "esc" || part == "escape")
+      key = ImGuiKey_Escape;
+    else if (part == "tab")
+      key = ImGuiKey_Tab;
+    else if (part == "enter")
+      key = ImGuiKey_Enter;
+    else if (part == "space")
+      key = ImGuiKey_Space;
+    else if (part.size() == 1 && part[0] >= 'a' && part[0] <= 'z')
+      key = static_cast<ImGuiKey>(ImGuiKey_A + (part[0] - 'a'));
+    else if (part.size() == 1 && part[0] >= '0' && part[0] <= '9')
+      key = static_cast<ImGuiKey>(ImGuiKey_0 + (part[0] - '0'));
+    else
+      return false;
+  }
+  return key != ImGuiKey_None;
+}
+// }}} Script
+
+// Player {{{
+struct FrameSample
+{
+  double frame;  // ms, editor update + draw + ImGui::Render
+  double update; // ms, NetworkView::update
+  double draw;   // ms, NetworkView::draw
+  int    vertices;
+};
+
+class Player
+{
+  std::shared_ptr<NodeGraphEditor> editor_;
+  NetworkView*                     view_   = nullptr;
+  Vec2                             mouse_  = {0, 0};
+  String                           phase_  = "default";
+  Vector<String>                   phases_; // in order of appearance
+  HashMap<String, Vector<FrameSample>> samples_;
+
+public:
+  Player(std::shared_ptr<NodeGraphEditor> editor) : editor_(std::move(editor)) {}
+
+  auto const& phases() const { return phases_; }
+  auto const& samples(String const& phase) const { return samples_.at(phase); }
+
+  NetworkView* findView()
+  {
+    if (!view_)
+      for (auto const& view : editor_->views())
+        if (view->kind() == "network")
+          view_ = dynamic_cast<NetworkView*>(view.get());
+    return view_;
+  }
+
+  void frame(std::function<void(ImGuiIO&)> const& input = nullptr)
+  {
+    auto& io     = ImGui::GetIO();
+    io.DeltaTime = 1.f / 60.f;
+    io.AddMousePosEvent(mouse_.x, mouse_.y);
+    if (input)
+      input(io);
+
+    auto const start = std::chrono::steady_clock::now();
+    ImGui::NewFrame();
+    ImGui::PushFont(ImGuiResource::instance().sansSerifFont);
+    editor_->update(io.DeltaTime);
+    editor_->draw();
+    ImGui::PopFont();
+    ImGui::Render();
+    renderNull(ImGui::GetDrawData());
+    auto const elapsed =
+      std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    FrameSample sample = {elapsed, 0, 0, ImGui::GetDrawData()->TotalVtxCount};
+    if (auto* view = findView()) {
+      sample.update = view->frameTime().update * 1e3;
+      sample.draw   = view->frameTime().draw * 1e3;
+    }
+    if (samples_.find(phase_) == samples_.end())
+      phases_.push_back(phase_);
+    samples_[phase_].push_back(sample);
+  }
+
+  // resolves a script target to a position in ImGui screen space
+  bool resolve(StringView target, Vec2& result)
+  {
+    enum class Target { Point, Node, Empty } kind = Target::Point;
+    if (utils::startswith(target, "node:")) {
+      kind   = Target::Node;
+      target = target.substr(5);
+    } else if (utils::startswith(target, "empty:")) {
+      kind   = Target::Empty;
+      target = target.substr(6);
+    }
+    auto uv = utils::strsplit(target, ",");
+    if (uv.size() != 2)
+      return false;
+    Vec2 const rel = {std::stof(String(uv[0])), std::stof(String(uv[1]))};
+    auto*      view = findView();
+    if (!view || !view->graph()) {
+      auto const& io = ImGui::GetIO();
+      result         = Vec2(io.DisplaySize.x * rel.x, io.DisplaySize.y * rel.y);
+      return true;
+    }
+    auto* canvas = view->canvas();
+    auto* graph  = view->graph().get();
+    auto  vp     = canvas->viewport();
+    Vec2  pos    = vp.min + Vec2(vp.width() * rel.x, vp.height() * rel.y);
+
+    Vector<GraphItem*> items;
+    if (kind == Target::Node) {
+      graph->itemsInBound(vp, items);
+      float nearest = std::numeric_limits<float>::max();
+      for (auto* item : items) {
+        if (!item->asNode())
+          continue;
+        auto d = gmath::distance(item->aabb().center(), pos);
+        if (d < nearest) {
+          nearest = d;
+          result  = item->aabb().center();
+        }
+      }
+      if (nearest == std::numeric_limits<float>::max())
+        return false;
+      result = canvas->canvasToScreen().transformPoint(result);
+      return true;
+    } else if (kind == Target::Empty) {
+      // spiral outwards until nothing is under (or right next to) the cursor
+      float const step  = 8.f / canvas->viewScale();
+      bool        found = false;
+      for (int ring = 0; ring < 256 && !found; ++ring) {
+        for (int i = 0, n = std::max(1, ring * 8); i < n && !found; ++i) {
+          float const angle = float(i) / float(n) * 6.2831853f;
+          Vec2 const  probe = pos + Vec2(std::cos(angle), std::sin(angle)) * (step * float(ring));
+          if (!vp.contains(probe))
+            continue;
+          items.clear();
+          graph->itemsInBound(AABB(probe).expanded(step * 2.f), items);
+          if (items.empty()) {
+            pos   = probe;
+            found = true;
+          }
+        }
+      }
+      if (!found)
+        return false;
+    }
+    result = canvas->canvasToScreen().transformPoint(pos);
+    return true;
+  }
+
+  bool run(Command const& cmd)
+  {
+    auto count = [&cmd](size_t i, int fallback) {
+      return i < cmd.args.size() ? std::max(1, std::stoi(cmd.args[i])) : fallback;
+    };
+    auto const numArgs = cmd.args.size();
+    if (cmd.op == "phase" && numArgs == 1) {
+      phase_ = cmd.args[0];
+    } else if (cmd.op == "frames" && numArgs == 1) {
+      for (int i = 0, n = count(0, 1); i < n; ++i)
+        frame();
+    } else if (cmd.op == "move" && (numArgs == 1 || numArgs == 2)) {
+      Vec2 target;
+      if (!resolve(cmd.args[0], target))
+        return false;
+      Vec2 const from = mouse_;
+      for (int i = 1, n = count(1, 1); i <= n; ++i) {
+        mouse_ = from + (target - from) * (float(i) / float(n));
+        frame();
+      }
+    } else if ((cmd.op == "down" || cmd.op == "up") && numArgs == 1) {
+      ImGuiMouseButton button;
+      if (!parseButton(cmd.args[0], button))
+        return false;
+      bool const down = cmd.op == "down";
+      frame([button, down](ImGuiIO& io) { io.AddMouseButtonEvent(button, down); });
+    } else if (cmd.op == "click" && numArgs == 1) {
+      ImGuiMouseButton button;
+      if (!parseButton(cmd.args[0], button))
+        return false;
+      frame([button](ImGuiIO& io) { io.AddMouseButtonEvent(button, true); });
+      frame([button](ImGuiIO& io) { io.AddMouseButtonEvent(button, false); });
+    } else if (cmd.op == "wheel" && (numArgs == 1 || numArgs == 2)) {
+      float const dy = std::stof(cmd.args[0]);
+      for (int i = 0, n = count(1, 1); i < n; ++i)
+        frame([dy](ImGuiIO& io) { io.AddMouseWheelEvent(0.f, dy); });
+    } else if (cmd.op == "key" && numArgs == 1) {
+      ImGuiKeyChord mods;
+      ImGuiKey      key;
+      if (!parseChord(cmd.args[0], mods, key))
+        return false;
+      auto press = [mods, key](bool down) {
+        return [mods, key, down](ImGuiIO& io) {
+          for (auto mod : {ImGuiMod_Ctrl, ImGuiMod_Shift, ImGuiMod_Alt})
+            if (mods & mod)
+              io.AddKeyEvent(mod, down);
+          io.AddKeyEvent(key, down);
+        };
+      };
+      frame(press(true));
+      frame(press(false));
+    } else if (cmd.op == "zoom" && numArgs == 1) {
+      auto* view = findView();
+      if (!view)
+        return false;
+      auto* canvas = view->canvas();
+      auto  center = canvas->viewport().center();
+      auto  scale  = std::stof(cmd.args[0]);
+      canvas->setViewScale(scale);
+      canvas->setViewPos(center * scale);
+    } else {
+      return false;
+    }
+    return true;
+  }
+};
+// }}} Player
+
+// Report {{{
+static Json summarize(Vector<FrameSample> const& samples, double FrameSample::*field)
+{
+  Vector<double> values;
+  for (auto const& s : samples)
+    values.push_back(s.*field);
+  std::sort(values.begin(), values.end());
+  double sum = 0;
+  for (auto v : values)
+    sum += v;
+  auto pct = [&values](double p) {
+    return values[std::min(values.size() - 1, size_t(p * double(values.size())))];
+  };
+  return {
+    {"mean", sum / double(values.size())},
+    {"p50", pct(0.5)},
+    {"p95", pct(0.95)},
+    {"max", values.back()}};
+}
+// }}} Report
+
+static bool runOnce(
+  size_t                           items,
+  String const&                    docPath,
+  Vector<Command> const&           script,
+  Vec2                             displaySize,
+  int                              run,
+  bool                             perFrame,
+  String const&                    snapshot,
+  std::function<void(Json const&)> emit)
+{
+  ImGui::CreateContext();
+  auto& io       = ImGui::GetIO();
+  io.IniFilename = nullptr;
+  io.ConfigFlags |= ImGuiConfigFlags_DockingEnable;
+  io.DisplaySize = ImVec2(displaySize.x, displaySize.y);
+  ImGui::StyleColorsDark();
+  ImGuiResource::reloadFonts();
+  initNullRenderer();
+
+  bool ok = true;
+  {
+    auto editor = newImGuiNodeGraphEditor();
+    editor->setResponser(std::make_shared<DefaultImGuiResponser>());
+    editor->setItemFactory(addImGuiItems(defaultGraphItemFactory()));
+    editor->setViewFactory(defaultViewFactory());
+    editor->setNodeFactory(std::make_shared<BenchNodeFactory>());
+    editor->initCommands();
+
+    NodeGraphEditor::DocPtr doc;
+    if (!docPath.empty()) {
+      doc = editor->openDoc(docPath);
+    } else {
+      doc = editor->createNewDocAndDefaultViews();
+      if (doc && !generateGrid(doc->root().get(), items))
+        doc = nullptr;
+    }
+    if (!doc) {
+      msghub::error("failed to prepare the document");
+      ok = false;
+    }
+
+    Player player(editor);
+    for (size_t i = 0; ok && i < script.size(); ++i) {
+      if (!player.run(script[i])) {
+        msghub::errorf("script line {}: cannot run \"{}\"", script[i].line, script[i].op);
+        ok = false;
+      }
+    }
+    if (ok && !snapshot.empty()) {
+      auto*        view = player.findView();
+      RasterCanvas canvas(int(displaySize.x), int(displaySize.y));
+      canvas.beginFrame(0x333333ff);
+      canvas.drawGraph(view ? view->graph().get() : doc->root().get());
+      canvas.endFrame();
+      if (!canvas.savePNG(snapshot))
+        msghub::errorf("failed to save snapshot to {}", snapshot);
+    }
+    for (auto const& phase : ok ? player.phases() : Vector<String>{}) {
+      auto const& samples  = player.samples(phase);
+      auto const  numItems = doc->numItems();
+      if (perFrame) {
+        for (size_t i = 0; i < samples.size(); ++i)
+          emit({
+            {"items", numItems},
+            {"run", run},
+            {"phase", phase},
+            {"frame", i},
+            {"frame_ms", samples[i].frame},
+            {"update_ms", samples[i].update},
+            {"draw_ms", samples[i].draw},
+            {"vertices", samples[i].vertices}});
+      }
+      Json record = {
+        {"items", numItems},
+        {"run", run},
+        {"phase", phase},
+        {"frames", samples.size()},
+        {"frame_ms", summarize(samples, &FrameSample::frame)},
+        {"update_ms", summarize(samples, &FrameSample::update)},
+        {"draw_ms", summarize(samples, &FrameSample::draw)}};
+      double vertices = 0;
+      for (auto const& s : samples)
+        vertices += s.vertices;
+      record["vertices"] = vertices / double(samples.size());
+      emit(record);
+      std::cerr << fmt::format(
+        "{:>8} run {} {:>12} {:>4} frames  frame {:>8.3f}  update {:>8.3f}  draw {:>8.3f} ms\n",
+        numItems,
+        run,
+        phase,
+        samples.size(),
+        record["frame_ms"]["mean"].get<double>(),
+        record["update_ms"]["mean"].get<double>(),
+        record["draw_ms"]["mean"].get<double>());
+    }
+  }
+  ImGui::DestroyContext();
+  return ok;
+}
+
+int main(int argc, char** argv)
+{
+  Vector<size_t> sizes      = {10000};
+  String         docPath    = "";
+  String         scriptText = defaultScript;
+  int            repeat     = 3;
+  Vec2           display    = {1920, 1080};
+  bool           perFrame   = false;
+  String         snapshot   = "";
+  String         out        = "";
+
+  for (int i = 1; i < argc; ++i) {
+    StringView arg = argv[i];
+    auto       eq  = arg.find('=');
+    auto       key = arg.substr(0, eq);
+    auto       val = eq == StringView::npos ? StringView() : arg.substr(eq + 1);
+    if (key == "--items") {
+      sizes.clear();
+      for (auto part : utils::strsplit(val, ","))
+        if (!part.empty())
+          sizes.push_back(std::stoull(String(part)));
+    } else if (key == "--doc")
+      docPath = String(val);
+    else if (key == "--script") {
+      std::ifstream file{String(val)};
+      if (!file.good()) {
+        std::cerr << "cannot read " << val << '\n';
+        return 1;
+      }
+      scriptText.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    } else if (key == "--repeat")
+      repeat = std::max(1, std::stoi(String(val)));
+    else if (key == "--size") {
+      auto wh = utils::strsplit(val, "x");
+      if (wh.size() == 2)
+        display = Vec2(std::stof(String(wh[0])), std::stof(String(wh[1])));
+    } else if (key == "--per-frame")
+      perFrame = true;
+    else if (key == "--snapshot")
+      snapshot = String(val);
+    else if (key == "--out")
+      out = String(val);
+    else {
+      std::cerr << "usage: " << argv[0]
+                << " [--items=10000] [--doc=file] [--script=file] [--repeat=3]"
+                   " [--size=1920x1080] [--per-frame] [--snapshot=file.png]"
+                   " [--out=results.jsonl]\n";
+      return arg == "--help" || arg == "-h" ? 0 : 1;
+    }
+  }
+
+  spdlog::set_level(spdlog::level::warn);
+  MessageHub::instance().setMinVerbosity(MessageHub::Verbosity::Warning);
+
+  std::ofstream outfile;
+  if (!out.empty()) {
+    outfile.open(out);
+    if (!outfile.good()) {
+      std::cerr << "cannot open " << out << " for writing\n";
+      return 1;
+    }
+  }
+  std::ostream& os   = out.empty() ? std::cout : outfile;
+  auto          emit = [&os](Json const& line) { os << line.dump() << std::endl; };
+
+  auto const script = parseScript(scriptText);
+  addImGuiInteractions();
+  if (!docPath.empty())
+    sizes = {0};
+  for (auto size : sizes)
+    for (int run = 0; run < repeat; ++run)
+      if (!runOnce(size, docPath, script, display, run, perFrame, snapshot, emit))
+        return 1;
+  return 0;
+}
@@ -0,0 +1,372 @@
+#include "parmscript.h"
+#include "binparm.h"
+#include <cstring>
+
+#ifdef DEBUG
+#include <stdio.h>
+#define WARN(...) fprintf(stderr, __VA_ARGS__)
+#else
+#define WARN(...) /*nothing*/
+#endif
+
+// layout:
+//   blob   := 'P' 'B' version parm
+//   parm   := 'f' type(u8) payload          -- field, payload is the raw value,
+//                                              strings are varint length + bytes
+//           | 'm' zigzag varint             -- menu
+//           | 's' varint(n) (name parm)*n   -- struct or group, name is a string
+//           | 'l' varint(n) parm*n          -- list, the items are structs
+//           | 'n'                           -- labels / buttons / spacers / separators
+// fields are matched by name like jsonparm does, fields that are missing from the template
+// or changed their type are skipped, so snapshots survive edits of the parm script
+namespace parmscript {
+
+static constexpr uint8_t binaryVersion = 2;
+
+enum Tag : uint8_t
+{
+  FieldTag  = 'f',
+  MenuTag   = 'm',
+  StructTag = 's',
+  ListTag   = 'l',
+  NoneTag   = 'n',
+};
+
+namespace {
+
+struct Writer
+{
+  std::vector<uint8_t>& out;
+
+  void byte(uint8_t b) { out.push_back(b); }
+  void varint(uint64_t v)
+  {
+    while (v >= 0x80) {
+      out.push_back(static_cast<uint8_t>(v) | 0x80);
+      v >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(v));
+  }
+  void zigzag(int64_t v) { varint((static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63)); }
+  template <class T>
+  void raw(T const& v)
+  {
+    auto size = out.size();
+    out.resize(size + sizeof(T));
+    std::memcpy(out.data() + size, &v, sizeof(T));
+  }
+  void str(string const& s)
+  {
+    varint(s.size());
+    out.insert(out.end(), s.begin(), s.end());
+  }
+};
+
+struct Reader
+{
+  uint8_t const* data;
+  size_t         size;
+  size_t         pos = 0;
+
+  bool byte(uint8_t& b)
+  {
+    if (pos >= size)
+      return false;
+    b = data[pos++];
+    return true;
+  }
+  bool varint(uint64_t& v)
+  {
+    v = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      uint8_t b = 0;
+      if (!byte(b))
+        return false;
+      v |= static_cast<uint64_t>(b & 0x7f) << shift;
+      if (!(b & 0x80))
+        return true;
+    }
+    return false;
+  }
+  bool zigzag(int64_t& v)
+  {
+    uint64_t u = 0;
+    if (!varint(u))
+      return false;
+    v = static_cast<int64_t>(u >> 1) ^ -static_cast<int64_t>(u & 1);
+    return true;
+  }
+  template <class T>
+  bool raw(T& v)
+  {
+    if (size - pos < sizeof(T))
+      return false;
+    std::memcpy(&v, data + pos, sizeof(T));
+    pos += sizeof(T);
+    return true;
+  }
+  bool str(string& s)
+  {
+    uint64_t len = 0;
+    if (!varint(len) || size - pos < len)
+      return false;
+    s.assign(reinterpret_cast<char const*>(data + pos), len);
+    pos += len;
+    return true;
+  }
+};
+
+bool isContainer(Parm const& p)
+{
+  return p.ui() == Parm::ui_type_enum::STRUCT || p.ui() == Parm::ui_type_enum::GROUP;
+}
+
+Tag tagOf(Parm const& p)
+{
+  if (p.ui() == Parm::ui_type_enum::FIELD)
+    return FieldTag;
+  if (p.ui() == Parm::ui_type_enum::MENU)
+    return MenuTag;
+  if (isContainer(p))
+    return StructTag;
+  if (p.ui() == Parm::ui_type_enum::LIST)
+    return ListTag;
+  return NoneTag;
+}
+
+void write(Writer& w, Parm const& p)
+{
+  using value_type_enum = Parm::value_type_enum;
+  auto tag              = tagOf(p);
+  w.byte(tag);
+  if (tag == FieldTag) {
+    w.byte(static_cast<uint8_t>(p.type()));
+    switch (p.type()) {
+      case value_type_enum::BOOL:   w.byte(p.as<bool>() ? 1 : 0); break;
+      case value_type_enum::INT:    w.raw(p.as<int>()); break;
+      case value_type_enum::FLOAT:  w.raw(p.as<float>()); break;
+      case value_type_enum::DOUBLE: w.raw(p.as<double>()); break;
+      case value_type_enum::INT2:   w.raw(p.as<Parm::int2>()); break;
+      case value_type_enum::FLOAT2: w.raw(p.as<Parm::float2>()); break;
+      case value_type_enum::FLOAT3: w.raw(p.as<Parm::float3>()); break;
+      case value_type_enum::FLOAT4: w.raw(p.as<Parm::float4>()); break;
+      case value_type_enum::COLOR:  w.raw(p.as<Parm::color>()); break;
+      case value_type_enum::STRING: w.str(p.as<string>()); break;
+      default: break;
+    }
+  } else if (tag == MenuTag) {
+    w.zigzag(p.as<int>());
+  } else if (tag == StructTag) {
+    w.varint(p.numFields());
+    for (size_t i = 0, n = p.numFields(); i < n; ++i) {
+      auto field = p.getField(i);
+      w.str(field->name());
+      write(w, *field);
+    }
+  } else if (tag == ListTag) {
+    w.varint(p.numListValues());
+    for (size_t i = 0, n = p.numListValues(); i < n; ++i)
+      write(w, *p.at(i));
+  }
+}
+
+size_t payloadSize(uint8_t type)
+{
+  using value_type_enum = Parm::value_type_enum;
+  switch (static_cast<value_type_enum>(type)) {
+    case value_type_enum::BOOL:   return 1;
+    case value_type_enum::INT:    return sizeof(int);
+    case value_type_enum::FLOAT:  return sizeof(float);
+    case value_type_enum::DOUBLE: return sizeof(double);
+    case value_type_enum::INT2:   return sizeof(Parm::int2);
+    case value_type_enum::FLOAT2: return sizeof(Parm::float2);
+    case value_type_enum::FLOAT3: return sizeof(Parm::float3);
+    case value_type_enum::FLOAT4: return sizeof(Parm::float4);
+    case value_type_enum::COLOR:  return sizeof(Parm::color);
+    default:                      return 0;
+  }
+}
+
+// walks over one encoded parm without looking at any template,
+// fails if the blob is malformed, so `read` below can no longer fail halfway
+bool skip(Reader& r, int depth = 0)
+{
+  uint8_t tag = 0;
+  if (depth > 64 || !r.byte(tag))
+    return false;
+  switch (tag) {
+    case FieldTag: {
+      uint8_t type = 0;
+      if (!r.byte(type))
+        return false;
+      if (static_cast<Parm::value_type_enum>(type) == Parm::value_type_enum::STRING) {
+        string s;
+        return r.str(s);
+      }
+      auto size = payloadSize(type);
+      if (r.size - r.pos < size)
+        return false;
+      r.pos += size;
+      return true;
+    }
+    case MenuTag: {
+      int64_t v = 0;
+      return r.zigzag(v);
+    }
+    case StructTag: {
+      uint64_t n = 0;
+      if (!r.varint(n))
+        return false;
+      string name;
+      for (uint64_t i = 0; i < n; ++i)
+        if (!r.str(name) || !skip(r, depth + 1))
+          return false;
+      return true;
+    }
+    case ListTag: {
+      uint64_t n = 0;
+      if (!r.varint(n))
+        return false;
+      for (uint64_t i = 0; i < n; ++i)
+        if (!skip(r, depth + 1))
+          return false;
+      return true;
+    }
+    case NoneTag: return true;
+    default:
+      WARN("binparm: unknown tag %d\n", int(tag));
+      return false;
+  }
+}
+
+template <class T>
+void readValue(Reader& r, Parm& p)
+{
+  T v;
+  r.raw(v);
+  p.set(v);
+}
+
+// reads a blob that `skip` accepted, values that do not fit `p` are skipped
+void read(Reader& r, Parm& p)
+{
+  using value_type_enum = Parm::value_type_enum;
+  auto const start      = r.pos;
+  uint8_t    tag        = 0;
+  r.byte(tag);
+  if (tag != tagOf(p)) {
+    WARN("binparm: \"%s\" changed its kind, skipped\n", p.path().c_str());
+    r.pos = start;
+    skip(r);
+    return;
+  }
+  if (tag == FieldTag) {
+    uint8_t type = 0;
+    r.byte(type);
+    if (type != static_cast<uint8_t>(p.type())) {
+      WARN("binparm: \"%s\" changed its type, skipped\n", p.path().c_str());
+      r.pos = start;
+      skip(r);
+      return;
+    }
+    switch (p.type()) {
+      case value_type_enum::BOOL: {
+        uint8_t b = 0;
+        r.byte(b);
+        p.set(b != 0);
+        break;
+      }
+      case value_type_enum::INT:    readValue<int>(r, p); break;
+      case value_type_enum::FLOAT:  readValue<float>(r, p); break;
+      case value_type_enum::DOUBLE: readValue<double>(r, p); break;
+      case value_type_enum::INT2:   readValue<Parm::int2>(r, p); break;
+      case value_type_enum::FLOAT2: readValue<Parm::float2>(r, p); break;
+      case value_type_enum::FLOAT3: readValue<Parm::float3>(r, p); break;
+      case value_type_enum::FLOAT4: readValue<Parm::float4>(r, p); break;
+      case value_type_enum::COLOR:  readValue<Parm::color>(r, p); break;
+      case value_type_enum::STRING: {
+        string s;
+        r.str(s);
+        p.set(std::move(s));
+        break;
+      }
+      default: break;
+    }
+  } else if (tag == MenuTag) {
+    int64_t v = 0;
+    r.zigzag(v);
+    p.set<int>(static_cast<int>(v));
+  } else if (tag == StructTag) {
+    uint64_t n = 0;
+    r.varint(n);
+    string name;
+    for (uint64_t i = 0; i < n; ++i) {
+      r.str(name);
+      // fields are usually still in template order
+      ParmPtr field = i < p.numFields() ? p.getField(i) : nullptr;
+      if (!field || field->name() != name)
+        field = p.getField(name);
+      if (field)
+        read(r, *field);
+      else
+        skip(r);
+    }
+  } else if (tag == ListTag) {
+    uint64_t n = 0;
+    r.varint(n);
+    p.resizeList(n);
+    for (size_t i = 0; i < n; ++i)
+      read(r, *p.at(i));
+  }
+}
+
+} // anonymous namespace
+
+void to_binary(std::vector<uint8_t>& out, Parm const& p)
+{
+  Writer w{out};
+  w.byte('P');
+  w.byte('B');
+  w.byte(binaryVersion);
+  write(w, p);
+}
+
+void to_binary(std::vector<uint8_t>& out, ParmSet const& p)
+{
+  if (auto root = p.get(""))
+    to_binary(out, *root);
+}
+
+bool from_binary(uint8_t const* data, size_t size, Parm& p)
+{
+  Reader r{data, size};
+  uint8_t magic[3] = {0};
+  if (!r.byte(magic[0]) || !r.byte(magic[1]) || !r.byte(magic[2]) ||
+      magic[0] != 'P' || magic[1] != 'B' || magic[2] != binaryVersion) {
+    WARN("binparm: bad header\n");
+    return false;
+  }
+  // validate everything before touching `p`, a rejected blob leaves it as it was
+  Reader check = r;
+  if (!skip(check))
+    return false;
+  if (check.pos != check.size) {
+    WARN("binparm: %zu trailing bytes\n", check.size - check.pos);
+    return false;
+  }
+  if (r.data[r.pos] != tagOf(p)) {
+    WARN("binparm: blob does not hold a \"%s\"\n", p.path().c_str());
+    return false;
+  }
+  read(r, p);
+  return true;
+}
+
+bool from_binary(std::vector<uint8_t> const& data, ParmSet& p)
+{
+  if (auto root = p.get(""))
+    return from_binary(data.data(), data.size(), *root);
+  return false;
+}
+
+} // namespace parmscript
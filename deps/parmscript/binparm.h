@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace parmscript {
+
+class Parm;
+class ParmSet;
+
+// compact binary encoding of parm values, an alternative to jsonparm for in-memory snapshots
+// fields are matched by name, fields the template lacks or that changed type are skipped;
+// `from_binary` returns false and leaves `p` untouched if the blob is malformed
+// or does not hold the same kind of parm as `p`
+void to_binary(std::vector<uint8_t>& out, Parm const& p);
+void to_binary(std::vector<uint8_t>& out, ParmSet const& p);
+bool from_binary(uint8_t const* data, size_t size, Parm& p);
+bool from_binary(std::vector<uint8_t> const& data, ParmSet& p);
+
+}
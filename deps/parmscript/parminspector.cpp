@@ -25,6 +25,133 @@ namespace parmscript {
 
 hashmap<string, FieldInspector> ParmSetInspector::inspectorOverrides_;
 
+struct ParmSetInspector::DisableWhen
+{
+  string                  expr;
+  lua_State*              lua = nullptr;
+  sol::protected_function fn;
+  int                     id = -1;           // parm id, it is dirty whenever anything the expression reads is
+  bool                    untracked = false; // reads something we cannot resolve, always re-evaluate
+  bool                    stale = true;
+  bool                    value = false;
+};
+
+// translate disablewhen expression into a Lua function body:
+//   {path.to.parm}           -> v("path.to.parm")
+//   {menu:path.to.parm::item} -> v("menu:path.to.parm::item")
+//   {length:path.to.parm}     -> v("length:path.to.parm")
+//   != -> ~=, || -> or, && -> and, ! -> not
+// `untracked` is set if any of the referred parms can not be resolved now (e.g. list items),
+// those are not covered by the dependency graph
+static bool translateDisableWhen(ParmSet& ps, string const& expr, string& body, bool& untracked)
+{
+  body.clear();
+  body.reserve(expr.size() * 2);
+  char quote = 0;
+  for (size_t i = 0; i < expr.size(); ++i) {
+    char c = expr[i];
+    if (quote) {
+      body += c;
+      if (c == '\\' && i + 1 < expr.size())
+        body += expr[++i];
+      else if (c == quote)
+        quote = 0;
+    } else if (c == '"' || c == '\'') {
+      quote = c;
+      body += c;
+    } else if (c == '{') {
+      auto end = expr.find('}', i + 1);
+      if (end == string::npos)
+        return false;
+      auto ref = expr.substr(i + 1, end - i - 1);
+      i = end;
+      body += "v(\"";
+      for (char rc: ref) {
+        if (rc == '"' || rc == '\\')
+          body += '\\';
+        body += rc;
+      }
+      body += "\")";
+
+      for (auto const& path: ParmSet::expressionRefs("{" + ref + "}"))
+        untracked |= !ps.get(path);
+    } else if (c == '!' && i + 1 < expr.size() && expr[i + 1] == '=') {
+      body += "~=";
+      ++i;
+    } else if (c == '|' && i + 1 < expr.size() && expr[i + 1] == '|') {
+      body += " or ";
+      ++i;
+    } else if (c == '&' && i + 1 < expr.size() && expr[i + 1] == '&') {
+      body += " and ";
+      ++i;
+    } else if (c == '!') {
+      body += "not ";
+    } else {
+      body += c;
+    }
+  }
+  return quote == 0;
+}
+
+bool ParmSetInspector::disabled(Parm const& parm, string const& expr, lua_State* L)
+{
+  auto& entry = disableWhen_[parm.path()];
+  if (!entry || entry->expr != expr || entry->lua != L) {
+    entry = std::make_shared<DisableWhen>();
+    entry->expr = expr;
+    entry->lua = L;
+    entry->id = parm.id();
+    string body;
+    if (!translateDisableWhen(*parmset_, expr, body, entry->untracked)) {
+      WARN("failed to parse disablewhen \"%s\"\n", expr.c_str());
+      entry->stale = false;
+      return false;
+    }
+    sol::state_view lua{L};
+    auto loaded = lua.load(R"LUA(
+local ps, evalParm = ...
+local function v(expr)
+  local e = evalParm(ps, expr)
+  if e == nil then error('{error}', 0) end
+  return e
+end
+return function() return ()LUA" + body + R"LUA() end
+)LUA", "disablewhen", sol::load_mode::text);
+    if (!loaded.valid()) {
+      WARN("failed to load disablewhen \"%s\"\n", expr.c_str());
+      entry->stale = false;
+      return false;
+    }
+    sol::protected_function chunk = loaded;
+    auto made = chunk(parmset_.get(), ParmSet::evalParm);
+    if (!made.valid() || made.get_type() != sol::type::function) {
+      entry->stale = false;
+      return false;
+    }
+    entry->fn = made.get<sol::protected_function>();
+  }
+  if (!entry->fn.valid())
+    return entry->value;
+
+  if (entry->stale || entry->untracked || parmset_->isDirty(entry->id)) {
+    auto result = entry->fn();
+    // unresolvable parms raise an error, which means not disabled
+    entry->value = result.valid() && result.get<bool>();
+    entry->stale = false;
+  }
+  return entry->value;
+}
+
+void ParmSetInspector::invalidateDisableWhen()
+{
+  if (parmset_->dirtyParmIds().empty())
+    return;
+  for (auto& [path, entry]: disableWhen_) {
+    if (parmset_->isDirty(entry->id))
+      entry->stale = true;
+  }
+}
+
 static std::string parmlabel(Parm const& parm)
 {
   return parm.label() + "##" + parm.path();
@@ -134,7 +261,7 @@ bool colorFieldInspector(Parm& parm)
   return imdirty;
 }
 
-bool ParmSetInspector::inspect(Parm& parm, hashset<string>& modified, lua_State* L, ParmFonts* fonts)
+bool ParmSetInspector::inspect(Parm& parm, lua_State* L, ParmFonts* fonts)
 {
   bool imdirty = false;
   bool displayChildren = true;
@@ -158,42 +285,9 @@ bool ParmSetInspector::inspect(Parm& parm, hashset<string>& modified, lua_State*
     itemWidthPushed = true;
   }
   if (!disablewhen.empty()) {
-    // expand {path.to.parm} to its value
-    // expand {menu:path.to.parm::item} to its value
-    // expand {length:path.to.parm} to its value
-    // translate != into ~=, || into or, && into and, ! into not
-    // evaluate disablewhen expr in Lua
-
-    // init the eval function:
-    bool disabled = false;
-
     if (L == nullptr)
       L = parmset_->defaultLuaRuntime();
-    sol::state_view lua{L};
-    auto loaded = lua.load(R"LUA(
-local ps, evalParm, expr=...
-return expr:gsub('{([^}]+)}', function(expr)
-  local e = evalParm(ps, expr)
-  if e~=nil then
-    return string.format("%q", e)
-  else
-    return '{error}'
-  end
-end):gsub('!=', '~='):gsub('||', ' or '):gsub('&&', ' and '):gsub('!', 'not ')
-    )LUA");
-    if (loaded.valid()) {
-      std::string expanded = loaded.call(parm.root(), ParmSet::evalParm, disablewhen);
-      // INFO("disablewhen \"%s\" expanded to \"%s\"\n", disablewhen.c_str(), expanded.c_str());
-      if (expanded.find("{error}") == std::string::npos) {
-        loaded = lua.load("return "+expanded, "disablewhen", sol::load_mode::text);
-        if (loaded.valid()) {
-          disabled = loaded.call();
-        }
-      }
-    } else {
-      WARN("failed to load disablewhen script");
-    }
-
+    bool disabled = this->disabled(parm, disablewhen, L);
     ImGui::BeginDisabled(disabled);
   }
 
@@ -215,12 +309,11 @@ end):gsub('!=', '~='):gsub('||', ' or '):gsub('&&', ' and '):gsub('!', 'not ')
     int numitems = parm.numListValues();
     if (ImGui::InputInt(("# "+label).c_str(), &numitems)) {
       parm.resizeList(numitems);
-      modified.insert(parm.path());
       imdirty = true;
     }
     for (int i=0; i<numitems; ++i) {
       for (auto field: parm.getListStruct(i)->allFields()) {
-        imdirty |= inspect(*field, modified, L, fonts);
+        imdirty |= inspect(*field, L, fonts);
       }
       if (i+1<numitems)
         ImGui::Separator();
@@ -229,7 +322,7 @@ end):gsub('!=', '~='):gsub('||', ' or '):gsub('&&', ' and '):gsub('!', 'not ')
     ImGui::TextUnformatted(parm.label().c_str());
   } else if (ui  == ui_type_enum::BUTTON) {
     if (ImGui::Button(label.c_str())) {
-      modified.insert(parm.path());
+      parmset_->markDirty(parm);
       // TODO: callback(?)
     }
   } else if (ui == ui_type_enum::SPACER) {
@@ -250,7 +343,7 @@ end):gsub('!=', '~='):gsub('||', ' or '):gsub('&&', ' and '):gsub('!', 'not ')
 
   if (displayChildren && parm.numFields() != 0) {
     for (auto child: parm.allFields())
-      imdirty |= inspect(*child, modified, L, fonts);
+      imdirty |= inspect(*child, L, fonts);
   }
   if (ui == ui_type_enum::STRUCT && displayChildren) {
     ImGui::TreePop();
@@ -264,7 +357,7 @@ end):gsub('!=', '~='):gsub('||', ' or '):gsub('&&', ' and '):gsub('!', 'not ')
     ImGui::EndDisabled();
   }
   if (imdirty) {
-    modified.insert(parm.path());
+    parmset_->markDirty(parm);
     if (ui != ui_type_enum::BUTTON) {
       edited_ = true;
       if (ImGui::IsMouseDown(ImGuiMouseButton_Left))
@@ -322,6 +415,8 @@ void ParmSetInspector::loadParmScript(std::string_view script)
   auto newparms = std::make_unique<ParmSet>();
   newparms->loadScript(script);
   parmset_.swap(newparms);
+  disableWhen_.clear();
+  handles_.clear();
 }
 
 bool ParmSetInspector::inspect(lua_State* L, ParmFonts* fonts)
@@ -330,11 +425,13 @@ bool ParmSetInspector::inspect(lua_State* L, ParmFonts* fonts)
     return false;
   if (L == nullptr)
     L = parmset_->defaultLuaRuntime();
+  // changes made outside of the inspector (scripts, undo, ...) since last frame
+  invalidateDisableWhen();
   parmset_->clearDirtyEntries();
   for (auto child: parmset_->root_->allFields())
-    inspect(*child, parmset_->dirtyEntries_, L, fonts);
-  edited_ |= !parmset_->dirtyEntries_.empty();
-  return !parmset_->dirtyEntries_.empty();
+    inspect(*child, L, fonts);
+  edited_ |= !parmset_->dirtyParmIds().empty();
+  return !parmset_->dirtyParmIds().empty();
 }
 
 }
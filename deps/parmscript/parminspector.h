@@ -22,7 +22,16 @@ protected:
   std::unique_ptr<ParmSet> parmset_;
   static hashmap<string, FieldInspector> inspectorOverrides_;
 
-  bool inspect(Parm& parm, hashset<string>& dirty, lua_State* L = nullptr, ParmFonts* fonts = nullptr);
+  // disablewhen expressions are compiled once per parm, and only re-evaluated when
+  // one of the parms they read has changed
+  struct DisableWhen;
+  hashmap<string, std::shared_ptr<DisableWhen>> disableWhen_;
+  // `getParm()` resolves each path once, handles are dropped along with the parm set
+  hashmap<string, ParmHandle> handles_;
+
+  bool inspect(Parm& parm, lua_State* L = nullptr, ParmFonts* fonts = nullptr);
+  bool disabled(Parm const& parm, string const& expr, lua_State* L);
+  void invalidateDisableWhen();
 
 public:
   ParmSetInspector()
@@ -35,19 +44,25 @@ public:
   }
   static FieldInspector getFieldInspector(Parm const& parm);
 
-  void setParms(std::unique_ptr<ParmSet> parms) { parmset_ = std::move(parms); }
+  void setParms(std::unique_ptr<ParmSet> parms) { parmset_ = std::move(parms); disableWhen_.clear(); handles_.clear(); }
   void loadParmScript(std::string_view script);
   auto& parms() { return *parmset_; }
   auto getParm(string const& name) -> ParmPtr
   {
     if (empty()) return nullptr;
-    return parmset_->get(name);
+    auto itr = handles_.find(name);
+    if (itr == handles_.end())
+      itr = handles_.insert({name, parmset_->handle(name)}).first;
+    if (itr->second)
+      return itr->second.ptr();
+    return parmset_->get(name); // list items have no handle of their own
   }
   auto const& parms() const { return *parmset_; }
   bool        empty() const { return !parmset_ || !parmset_->loaded(); }
 
   bool inspect(lua_State* L=nullptr, ParmFonts* fonts=nullptr);
   auto const& dirtyEntries() const { return parmset_->dirtyEntries(); }
+  auto const& dirtyParmIds() const { return parmset_->dirtyParmIds(); }
   bool doneEditing() const { return edited_ && !editing_; } // supposed to be used as save points
   bool edited() const { return edited_; }
   bool dirty() const { return edited_; }
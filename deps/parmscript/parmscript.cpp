@@ -2,6 +2,7 @@
 
 #include <array>
 #include <memory>
+#include <mutex>
 
 extern "C" {
 #include <stdint.h>
@@ -27,54 +28,59 @@ static const char parmexpr_src[] = {
 namespace parmscript {
 
 ParmPtr Parm::getField(string const& relpath) {
-  if (auto dot=relpath.find('.'); dot!=string::npos) {
-    if (auto f=getField(relpath.substr(0, dot)))
-      return f->getField(relpath.substr(dot+1));
-    else
+  return findField(relpath);
+}
+
+ParmPtr Parm::findField(std::string_view relpath) const {
+  auto dot  = relpath.find('.');
+  auto head = relpath.substr(0, dot);
+  auto childname = head;
+  int  idx = -1;
+  if (auto idxstart=head.find('['); idxstart!=std::string_view::npos) {
+    auto idxend = head.find(']', idxstart);
+    if (idxend==std::string_view::npos || idxend==idxstart+1)
       return nullptr;
-  } else {
-    string childname = relpath;
-    auto idxstart = relpath.find('[');
-    int idx = -1;
-    if (idxstart!=string::npos) {
-      auto idxend = relpath.find(']');
-      if (idxend==string::npos)
+    idx = 0;
+    for (auto c: head.substr(idxstart+1, idxend-idxstart-1)) {
+      if (c<'0' || c>'9')
         return nullptr;
-      string idxstr = relpath.substr(idxstart+1, idxend-idxstart-1);
-      idx = std::stoi(idxstr);
-      childname = relpath.substr(0, idxstart);
+      idx = idx*10 + (c-'0');
     }
-    if (auto f = std::find_if(fields_.begin(), fields_.end(), [&childname](ParmPtr p){
-        return p->name()==childname;
-      });
-      f!=fields_.end()) {
-      if (idxstart!=string::npos) {
-        if (idx>=0 && idx<(*f)->listValues_.size()) {
-          return (*f)->listValues_[idx];
-        }
-      } else {
-        return *f;
-      }
+    childname = head.substr(0, idxstart);
+  }
+  ParmPtr found;
+  for (auto const& f: fields_) {
+    if (f->name()==childname) {
+      if (idx<0)
+        found = f;
+      else if (idx<f->listValues_.size())
+        found = f->listValues_[idx];
+      break;
     }
-    for (auto f : fields_) {
+  }
+  if (!found) {
+    for (auto const& f: fields_) {
       if (f->ui()==ui_type_enum::GROUP) { // group members are in current namespace
-        if (auto gf = f->getField(relpath))
-          return gf;
+        if ((found = f->findField(head)))
+          break;
       }
     }
   }
-  return nullptr;
+  if (!found || dot==std::string_view::npos)
+    return found;
+  return found->findField(relpath.substr(dot+1));
 }
 
 void Parm::resizeList(size_t cnt)
 {
-  root_->dirtyEntries_.insert(path());
+  root_->markDirty(*this);
   if (auto oldsize=listValues_.size(); oldsize<cnt) {
     for (auto i=oldsize; i<cnt; ++i) {
       auto newItem = std::make_shared<Parm>(root_);
       string indexstr = "["+std::to_string(i)+"]";
       newItem->setUI(ui_type_enum::STRUCT);
-      newItem->setPath(path_+indexstr);
+      newItem->setId(id());
+      newItem->setPath(path()+indexstr);
       listValues_.push_back(newItem);
       for (auto f: fields_) {
         auto newField = std::make_shared<Parm>(*f);
@@ -244,6 +250,7 @@ int ParmSet::processLuaParm(lua_State* lua)
   parent->addField(newparm);
   self->parms_.push_back(newparm);
   int  newid = self->parms_.size()-1;
+  newparm->setId(newid);
   sol::stack::push(lua, newid);
   INFO("done.\n");
   return 1;
@@ -363,10 +370,20 @@ int ParmSet::evalParm(lua_State* L)
 }
 
 void ParmSet::loadScript(std::string_view sv, lua_State* L)
+{
+  if (L == nullptr) {
+    instantiate(*compiledTemplate(sv));
+    return;
+  }
+  auto fullscript = preloadScript();
+  fullscript += "\n";
+  fullscript += sv;
+  parseScript(fullscript, L);
+}
+
+void ParmSet::parseScript(std::string_view fullscript, lua_State* L)
 {
   loaded_ = false;
-  if (L == nullptr)
-    L = defaultLuaRuntime();
   int luasp = lua_gettop(L); // stack pointer
   if (LUA_OK != luaL_loadbufferx(L, parmexpr_src, sizeof(parmexpr_src)-1, "parmexpr", "t")) {
     throw LoadError("failed to load parmexpr\n");
@@ -377,9 +394,6 @@ void ParmSet::loadScript(std::string_view sv, lua_State* L)
     throw LoadError("failed to call parmexpr\n");
     return;
   }
-  auto fullscript = preloadScript();
-  fullscript += "\n";
-  fullscript += sv;
   lua_pushlstring(L, fullscript.data(), fullscript.size());
   if (LUA_OK != lua_pcall(L, 1, 1, 0)) {
     std::string message = luaL_optstring(L, -1, "unknown");
@@ -389,7 +403,9 @@ void ParmSet::loadScript(std::string_view sv, lua_State* L)
   }
   root_  = std::make_shared<Parm>(nullptr);
   root_->setUI(Parm::ui_type_enum::STRUCT);
+  root_->setId(0);
   parms_ = {root_};
+  clearDirtyEntries();
 
   sol::state_view lua{L};
   auto loaded = lua.load(R"LUA(
@@ -424,9 +440,193 @@ end
   } else {
     throw LoadError("failed to load finalizing script\n");
   }
+  buildDependencies();
   loaded_ = true;
 }
 
+void ParmSet::instantiate(ParmSet const& proto)
+{
+  loaded_ = false;
+  if (!proto.root_)
+    throw LoadError("instantiating from an empty template\n");
+  root_  = std::make_shared<Parm>(*proto.root_); // deep copy, root parm has no owner
+  parms_ = {root_};
+  // re-own the copied tree, keep parms_ in the same (pre-)order as lua created them
+  auto adopt = [this](auto& adopt, Parm& parm, bool isDefinition) -> void {
+    for (auto& f: parm.fields_) {
+      f->root_ = this;
+      if (isDefinition)
+        parms_.push_back(f);
+      adopt(adopt, *f, isDefinition);
+    }
+    for (auto& v: parm.listValues_) {
+      v->root_ = this;
+      adopt(adopt, *v, false);
+    }
+  };
+  adopt(adopt, *root_, true);
+  dependents_ = proto.dependents_;
+  clearDirtyEntries();
+  loaded_ = proto.loaded_;
+}
+
+std::vector<string> const& ParmSet::expressionMetas()
+{
+  static std::vector<string> const metas = {"disablewhen"};
+  return metas;
+}
+
+std::vector<string> ParmSet::expressionRefs(string const& expr)
+{
+  std::vector<string> refs;
+  for (size_t start = expr.find('{'); start != string::npos; start = expr.find('{', start)) {
+    auto end = expr.find('}', start+1);
+    if (end == string::npos)
+      break;
+    auto ref = expr.substr(start+1, end-start-1);
+    if (ref.find("menu:")==0) {
+      ref = ref.substr(5, ref.find("::")==string::npos ? string::npos : ref.find("::")-5);
+    } else if (ref.find("length:")==0) {
+      ref = ref.substr(7);
+    }
+    refs.push_back(std::move(ref));
+    start = end+1;
+  }
+  return refs;
+}
+
+void ParmSet::buildDependencies()
+{
+  auto graph = std::make_shared<std::vector<std::vector<int>>>(parms_.size());
+  auto addEdge = [&graph](int from, int to) {
+    if (from<0 || to<0 || from==to)
+      return;
+    auto& deps = (*graph)[from];
+    if (std::find(deps.begin(), deps.end(), to) == deps.end())
+      deps.push_back(to);
+  };
+  for (auto const& parm: parms_) {
+    // containers depend on their fields
+    for (auto const& f: parm->fields_)
+      addEdge(f->id(), parm->id());
+    // expressions depend on parms they refer to
+    for (auto const& key: expressionMetas()) {
+      auto expr = parm->getMeta<string>(key, "");
+      for (auto const& ref: expressionRefs(expr)) {
+        if (auto target = get(ref))
+          addEdge(target->id(), parm->id());
+        else
+          WARN("%s of \"%s\" refers to unknown parm \"%s\"\n", key.c_str(), parm->path().c_str(), ref.c_str());
+      }
+    }
+  }
+  dependents_ = std::move(graph);
+}
+
+std::vector<int> const& ParmSet::dependents(int id) const
+{
+  static std::vector<int> const none;
+  if (!dependents_ || id<0 || id>=static_cast<int>(dependents_->size()))
+    return none;
+  return (*dependents_)[id];
+}
+
+void ParmSet::markDirty(Parm const& parm)
+{
+  int id = parm.id();
+  if (id>=0 && id<static_cast<int>(parms_.size()) && parms_[id].get()==&parm) {
+    if (modifiedBits_.size() != parms_.size())
+      modifiedBits_.resize(parms_.size(), false);
+    modifiedBits_[id] = true;
+  } else {
+    dirtyItemPaths_.insert(parm.path());
+  }
+  dirtyEntriesValid_ = false;
+  markDirty(id);
+}
+
+void ParmSet::markDirty(int id)
+{
+  if (id<0 || id>=static_cast<int>(parms_.size()))
+    return;
+  if (dirtyBits_.size() != parms_.size())
+    dirtyBits_.resize(parms_.size(), false);
+  if (dirtyBits_[id]) // its dependents are already dirty
+    return;
+  std::vector<int> stack = {id};
+  dirtyBits_[id] = true;
+  while (!stack.empty()) {
+    int cur = stack.back();
+    stack.pop_back();
+    dirtyIds_.push_back(cur);
+    for (int d: dependents(cur)) {
+      if (!dirtyBits_[d]) {
+        dirtyBits_[d] = true;
+        stack.push_back(d);
+      }
+    }
+  }
+}
+
+hashset<string> const& ParmSet::dirtyEntries() const
+{
+  if (!dirtyEntriesValid_) {
+    dirtyEntries_ = dirtyItemPaths_;
+    for (int id: dirtyIds_) {
+      if (id<static_cast<int>(modifiedBits_.size()) && modifiedBits_[id])
+        dirtyEntries_.insert(parms_[id]->path());
+    }
+    dirtyEntriesValid_ = true;
+  }
+  return dirtyEntries_;
+}
+
+void ParmSet::clearDirtyEntries()
+{
+  for (int id: dirtyIds_) {
+    dirtyBits_[id] = false;
+    if (id<static_cast<int>(modifiedBits_.size()))
+      modifiedBits_[id] = false;
+  }
+  dirtyIds_.clear();
+  dirtyItemPaths_.clear();
+  dirtyEntries_.clear();
+  dirtyEntriesValid_ = true;
+}
+
+ParmHandle ParmSet::handle(string const& path)
+{
+  auto parm = get(path);
+  if (!parm || !parmById(parm->id()) || parms_[parm->id()]!=parm)
+    return {};
+  return {this, parm->id()};
+}
+
+static std::mutex templateCacheMutex_;
+static hashmap<string, std::shared_ptr<const ParmSet>> templateCache_;
+
+std::shared_ptr<const ParmSet> ParmSet::compiledTemplate(std::string_view sv)
+{
+  auto fullscript = preloadScript();
+  fullscript += "\n";
+  fullscript += sv;
+
+  // the lock also serializes access to the default lua runtime
+  std::lock_guard<std::mutex> lock(templateCacheMutex_);
+  if (auto itr = templateCache_.find(fullscript); itr != templateCache_.end())
+    return itr->second;
+  auto proto = std::make_shared<ParmSet>();
+  proto->parseScript(fullscript, defaultLuaRuntime()); // throws on failure, nothing cached
+  templateCache_[fullscript] = proto;
+  return proto;
+}
+
+void ParmSet::clearTemplateCache()
+{
+  std::lock_guard<std::mutex> lock(templateCacheMutex_);
+  templateCache_.clear();
+}
+
 void ParmSet::exposeToLua(lua_State *L)
 {
   lua_CFunction luaopen_parmset = [](lua_State *L)->int {
@@ -8,6 +8,7 @@
 #include <numeric>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <unordered_set>
 #include <variant>
@@ -19,6 +20,7 @@ namespace parmscript {
 
 class Parm;
 class ParmSet;
+class ParmHandle;
 using ParmPtr = std::shared_ptr<Parm>;
 using ConstParmPtr = std::shared_ptr<const Parm>;
 using ParmSetPtr = std::shared_ptr<ParmSet>;
@@ -44,19 +46,27 @@ public:
   enum class ui_type_enum {
     FIELD, LABEL, BUTTON, SPACER, SEPARATOR, MENU, GROUP, STRUCT, LIST};
 
+  // everything that describes a parm but is not its value,
+  // shared by all instances created from the same script (copy-on-write)
+  struct Definition
+  {
+    int                         id=-1; // index into ParmSet's parms, shared by list items of the same field
+    ui_type_enum                ui_type=ui_type_enum::LABEL;
+    value_type_enum             expected_value_type=value_type_enum::NONE;
+    value_type                  default_value;
+    string                      name;
+    string                      path;
+    string                      label;
+    hashmap<string, value_type> meta;
+    std::vector<int>            menu_values;
+    std::vector<string>         menu_items;
+    std::vector<string>         menu_labels;
+  };
+
 protected:
   ParmSet                    *root_=nullptr;
-  ui_type_enum                ui_type_=ui_type_enum::LABEL;
-  value_type_enum             expected_value_type_;
+  std::shared_ptr<const Definition> def_;
   value_type                  value_;
-  value_type                  default_;
-  string                      name_;
-  string                      path_;
-  string                      label_;
-  hashmap<string, value_type> meta_;
-  std::vector<int>            menu_values_;
-  std::vector<string>         menu_items_;
-  std::vector<string>         menu_labels_;
   // if the scope is a plain struct, then this holds everything
   std::vector<ParmPtr>        fields_; 
   // if the scope is a list, fields_ holds the template (label / default value / everything)
@@ -84,23 +94,29 @@ protected:
     return s;
   }
 
+  static std::shared_ptr<const Definition> const& emptyDefinition()
+  {
+    static auto const empty = std::make_shared<const Definition>();
+    return empty;
+  }
+
+  // copy-on-write access for the setup functions below
+  Definition& def()
+  {
+    if (def_.use_count() != 1)
+      def_ = std::make_shared<const Definition>(*def_);
+    return const_cast<Definition&>(*def_);
+  }
+
 public:
-  Parm(ParmSet* root):root_(root){}
+  Parm(ParmSet* root):root_(root),def_(emptyDefinition()){}
   Parm(Parm&&)=default;
   ~Parm()=default;
+  // copies values, shares the definition
   Parm(Parm const& that)
     : root_(that.root_)
-    , ui_type_(that.ui_type_)
+    , def_(that.def_)
     , value_(that.value_)
-    , expected_value_type_(that.expected_value_type_)
-    , default_(that.default_)
-    , name_(that.name_)
-    , path_(that.path_)
-    , label_(that.label_)
-    , meta_(that.meta_)
-    , menu_values_(that.menu_values_)
-    , menu_items_(that.menu_items_)
-    , menu_labels_(that.menu_labels_)
   {
     fields_.reserve(that.fields_.size());
     for (auto f: that.fields_)
@@ -110,15 +126,17 @@ public:
       listValues_.push_back(std::make_shared<Parm>(*v));
   }
 
-  auto const& name() const { return name_; }
-  auto const& label() const { return label_; }
-  auto const& path() const { return path_; }
+  auto const& name() const { return def_->name; }
+  auto const& label() const { return def_->label; }
+  auto const& path() const { return def_->path; }
+  auto const  id() const { return def_->id; }
   auto const& value() const { return value_; }
-  auto const& defaultValue() const { return default_; }
-  auto const  type() const { return expected_value_type_; }
-  auto const  ui() const { return ui_type_; }
+  auto const& defaultValue() const { return def_->default_value; }
+  auto const  type() const { return def_->expected_value_type; }
+  auto const  ui() const { return def_->ui_type; }
   auto*       root() const { return root_; }
-  auto const& menuLabels() const { return menu_labels_; }
+  auto const& menuLabels() const { return def_->menu_labels; }
+  auto const& definition() const { return def_; }
 
   // retrieve value:
   template <class T>
@@ -134,10 +152,11 @@ public:
   template <class T>
   std::enable_if_t<std::is_same_v<T, int>, T>
   as() const {
-    if (ui_type_ == ui_type_enum::MENU) {
+    if (ui() == ui_type_enum::MENU) {
+      auto const& menu_values = def_->menu_values;
       int idx = std::get<int>(value_);
-      if (menu_values_.size() == menu_items_.size() && idx>=0 && idx<menu_values_.size()) {
-        return menu_values_[idx];
+      if (menu_values.size() == def_->menu_items.size() && idx>=0 && idx<menu_values.size()) {
+        return menu_values[idx];
       } else {
         return idx;
       }
@@ -148,10 +167,10 @@ public:
   template <class T>
   std::enable_if_t<std::is_same_v<T, string>, T>
   as() const {
-     if (ui_type_ == ui_type_enum::MENU) {
+     if (ui() == ui_type_enum::MENU) {
       int idx = std::get<int>(value_);
-      if (idx>=0 && idx<menu_items_.size()) {
-        return menu_items_[idx];
+      if (idx>=0 && idx<def_->menu_items.size()) {
+        return def_->menu_items[idx];
       } else {
         return string();
       }
@@ -169,7 +188,7 @@ public:
   template <class T>
   std::enable_if_t<std::is_same_v<T, string>, bool>
   is() const {
-    if (ui_type_ == ui_type_enum::MENU) {
+    if (ui() == ui_type_enum::MENU) {
       return std::holds_alternative<int>(value_);
     } else {
       return std::holds_alternative<string>(value_);
@@ -224,7 +243,7 @@ public:
   } 
 
   ParmPtr at(size_t idx) const {
-    if (ui_type_ != ui_type_enum::LIST)
+    if (ui() != ui_type_enum::LIST)
       throw std::domain_error("index into none-list parm");
     if (idx>=listValues_.size())
       throw std::out_of_range("index out of range");
@@ -244,7 +263,7 @@ public:
   template <class T>
   T getMeta(std::string const& key, T const& defaultval) const
   {
-    if(auto itr=meta_.find(key); itr!=meta_.end()) {
+    if(auto itr=def_->meta.find(key); itr!=def_->meta.end()) {
       if (std::holds_alternative<T>(itr->second)) {
         return std::get<T>(itr->second);
       } else {
@@ -256,13 +275,13 @@ public:
 
   bool hasMeta(std::string const& key) const
   {
-    return meta_.find(key) != meta_.end();
+    return def_->meta.find(key) != def_->meta.end();
   }
 
   template <class T>
   bool tryGetMeta(std::string const& key, T* retValue)
   {
-    if(auto itr=meta_.find(key); itr!=meta_.end()) {
+    if(auto itr=def_->meta.find(key); itr!=def_->meta.end()) {
       if (std::holds_alternative<T>(itr->second)) {
         *retValue = std::get<T>(itr->second);
         return true;
@@ -273,52 +292,58 @@ public:
 
 protected:
   friend class ParmSet;
+  ParmPtr findField(std::string_view relpath) const;
+
   // setup function should only be called by ParmSet
-  void setName(string name) { name_ = std::move(name); }
-  void setPath(string path) { path_ = std::move(path); }
-  void setUI(ui_type_enum type) {ui_type_ = type; }
-  void setType(value_type_enum type) {expected_value_type_ = type;}
+  void setId(int id) { def().id = id; }
+  void setName(string name) { def().name = std::move(name); }
+  void setPath(string path) { def().path = std::move(path); }
+  void setUI(ui_type_enum type) { def().ui_type = type; }
+  void setType(value_type_enum type) { def().expected_value_type = type; }
   void setAsField(value_type defaultValue) {
-    ui_type_ = ui_type_enum::FIELD;
+    auto& d = def();
+    d.ui_type = ui_type_enum::FIELD;
     value_ = defaultValue;
-    default_ = defaultValue;
+    d.default_value = defaultValue;
   }
-  void setLabel(string label) { label_ = std::move(label); }
-  void setMeta(string const& key, value_type value) { meta_[key] = std::move(value_); }
+  void setLabel(string label) { def().label = std::move(label); }
+  void setMeta(string const& key, value_type value) { def().meta[key] = std::move(value); }
   template <class T>
   void setMeta(string const& key, T const& value) {
-    meta_[key].emplace<T>(value);
+    def().meta[key].template emplace<T>(value);
   }
   void setMenu(std::vector<string> items, int defaultValue, std::vector<string> labels={}, std::vector<int> values={}) {
-    ui_type_ = ui_type_enum::MENU;
-    menu_items_ = std::move(items);
+    auto& d = def();
+    d.ui_type = ui_type_enum::MENU;
+    d.menu_items = std::move(items);
     value_ = defaultValue;
-    default_ = defaultValue;
+    d.default_value = defaultValue;
 
-    if (labels.size() == menu_items_.size())
-      menu_labels_ = std::move(labels);
+    if (labels.size() == d.menu_items.size())
+      d.menu_labels = std::move(labels);
     else {
-      menu_labels_.resize(menu_items_.size());
-      std::transform(menu_items_.begin(), menu_items_.end(), menu_labels_.begin(), titleize);
+      d.menu_labels.resize(d.menu_items.size());
+      std::transform(d.menu_items.begin(), d.menu_items.end(), d.menu_labels.begin(), titleize);
     }
 
-    if (values.size() == menu_items_.size())
-      menu_values_ = std::move(values);
+    if (values.size() == d.menu_items.size())
+      d.menu_values = std::move(values);
     else {
-      menu_values_.resize(menu_values_.size());
-      std::iota(menu_values_.begin(), menu_values_.end(), 0);
+      d.menu_values.resize(d.menu_values.size());
+      std::iota(d.menu_values.begin(), d.menu_values.end(), 0);
     }
   }
   void setup(string name, string path, string label, ui_type_enum ui, value_type_enum type, value_type defaultValue) {
     if (defaultValue.index() != static_cast<size_t>(type)) {
       throw std::invalid_argument("default value does not match type");
     }
-    name_    = std::move(name);
-    path_    = std::move(path);
-    label_   = std::move(label);
-    ui_type_ = ui;
-    expected_value_type_ = type;
-    default_ = defaultValue;
+    auto& d = def();
+    d.name    = std::move(name);
+    d.path    = std::move(path);
+    d.label   = std::move(label);
+    d.ui_type = ui;
+    d.expected_value_type = type;
+    d.default_value = defaultValue;
     value_   = defaultValue;
   }
   void addField(ParmPtr child) {
@@ -347,7 +372,18 @@ protected:
   ParmPtr              root_;
   std::vector<ParmPtr> parms_;
   bool                 loaded_ = false;
-  hashset<string>      dirtyEntries_;
+  // dependency graph, built once per script and shared by its instances:
+  // dependents_[id] are the parms that read parm `id`, either because they contain it
+  // (struct / list / group) or because one of their expressions (e.g. `disablewhen`) refers to it
+  std::shared_ptr<const std::vector<std::vector<int>>> dependents_;
+  // dirty tracking is done on parm ids, paths are only kept for list items
+  // (which share ids with their template field), `dirtyEntries()` builds the path set on demand
+  std::vector<int>     dirtyIds_;     // transitive closure of modified parms, in the order they got dirty
+  std::vector<bool>    dirtyBits_;    // bitset of `dirtyIds_`
+  std::vector<bool>    modifiedBits_; // parms modified directly, not through dependency
+  hashset<string>      dirtyItemPaths_;
+  mutable hashset<string> dirtyEntries_;
+  mutable bool         dirtyEntriesValid_ = true;
 
   static lua_State *defaultLuaRuntime(); // shared lua runtime for parmscript parsing and `disablewhen` expression evaluation
 
@@ -355,7 +391,15 @@ protected:
   static int pushParmValueToLuaStack(lua_State* L, ParmPtr parm);
   static int evalParm(lua_State* lua);
 
+  void parseScript(std::string_view fullscript, lua_State* runtime); // runs lua, builds parms_
+  void instantiate(ParmSet const& proto); // deep copies parms of `proto`, no lua involved
+  void buildDependencies();
+
+  void markDirty(Parm const& parm);
+  void markDirty(int id);
+
   friend class Parm;
+  friend class ParmHandle;
   friend class ParmSetInspector;
 
 public:
@@ -374,6 +418,12 @@ public:
 
   void loadScript(std::string_view script, lua_State* runtime=nullptr); // if no lua runtime was given, default shared lua runtime will be used
 
+  /// parsed parm sets, keyed by script text (with preload script):
+  /// `loadScript` without explicit runtime parses each distinct script only once,
+  /// following loads are instantiated from the cached prototype
+  static std::shared_ptr<const ParmSet> compiledTemplate(std::string_view script);
+  static void clearTemplateCache();
+
   bool loaded() const { return loaded_; }
 
   ParmPtr get(string const& key) {
@@ -384,32 +434,84 @@ public:
     if (key == "") return root_;
     return std::const_pointer_cast<const Parm>(root_->getField(key));
   }
-  auto const& dirtyEntries() const { return dirtyEntries_; }
-  void clearDirtyEntries() { dirtyEntries_.clear(); }
+  /// resolves `path` once, see `ParmHandle`
+  ParmHandle handle(string const& path);
+
+  /// paths of modified parms
+  hashset<string> const& dirtyEntries() const;
+  void clearDirtyEntries();
+
+  /// parm ids are stable for all instances of the same script
+  int     numParms() const { return static_cast<int>(parms_.size()); }
+  ParmPtr parmById(int id) const {
+    if (id>=0 && id<static_cast<int>(parms_.size()))
+      return parms_[id];
+    return nullptr;
+  }
+  /// ids of modified parms and everything depending on them
+  auto const& dirtyParmIds() const { return dirtyIds_; }
+  bool isDirty(int id) const { return id>=0 && id<static_cast<int>(dirtyBits_.size()) && dirtyBits_[id]; }
+  auto const& dirtyBits() const { return dirtyBits_; }
+  std::vector<int> const& dependents(int id) const;
+
+  /// metas holding expressions that may refer to other parms, like `disablewhen`
+  static std::vector<string> const& expressionMetas();
+  /// paths of the parms referred by `{path}`, `{menu:path::item}` and `{length:path}` in `expr`
+  static std::vector<string> expressionRefs(string const& expr);
 
   auto operator[](string const& key) { return get(key); }
   auto operator[](string const& key) const { return get(key); }
 };
 
+/// a parm resolved once by path, accesses afterwards index straight into the ParmSet
+/// stays valid as long as the ParmSet is alive and not reloaded with another script;
+/// list items share ids with their template, resolve the list and use `Parm::at()` for them
+class ParmHandle
+{
+  ParmSet* set_ = nullptr;
+  int      id_  = -1;
+
+public:
+  ParmHandle() = default;
+  ParmHandle(ParmSet* set, int id):set_(set),id_(id){}
+
+  int   id() const { return id_; }
+  bool  valid() const { return set_ && id_>=0 && id_<set_->numParms(); }
+  explicit operator bool() const { return valid(); }
+  Parm* get() const { return valid() ? set_->parms_[id_].get() : nullptr; }
+  ParmPtr ptr() const { return valid() ? set_->parms_[id_] : nullptr; }
+  Parm* operator->() const { return get(); }
+  Parm& operator*() const { return *get(); }
+  bool  dirty() const { return set_ && set_->isDirty(id_); }
+
+  template <class T>
+  T as() const { return get()->template as<T>(); }
+  template <class T>
+  bool set(T value) const { return get()->set(std::move(value)); }
+};
+
 template <class T>
 inline bool Parm::set(T value)
 {
   if constexpr (std::is_same_v<T, int>) {
-    if (ui_type_ == ui_type_enum::MENU) {
-      if (menu_values_.size() == menu_items_.size()) {
-        auto itr = std::find(menu_values_.begin(), menu_values_.end(), value);
-        if (itr == menu_values_.end())
+    if (ui() == ui_type_enum::MENU) {
+      auto const& menu_values = def_->menu_values;
+      if (menu_values.size() == def_->menu_items.size()) {
+        auto itr = std::find(menu_values.begin(), menu_values.end(), value);
+        if (itr == menu_values.end())
           value_ = 0;
         else
-          value_ = int(itr - menu_values_.begin());
+          value_ = int(itr - menu_values.begin());
       } else {
         value_ = value;
       }
     } else {
       value_ = value;
     }
+    root_->markDirty(*this);
+    return true;
   } else if (auto* ptr = std::get_if<T>(&value_)) {
-    root_->dirtyEntries_.insert(path());
+    root_->markDirty(*this);
     *ptr = std::move(value);
     return true;
   }
@@ -419,7 +521,7 @@ inline bool Parm::set(T value)
 template <class T>
 inline bool Parm::setListValue(size_t i, size_t f, T value)
 {
-  root_->dirtyEntries_.insert(path());
+  root_->markDirty(*this);
   return listValues_.at(i)->fields_.at(f)->set(std::move(value));
 }
 
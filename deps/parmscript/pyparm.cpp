@@ -154,6 +154,7 @@ void bindParmToPython(pybind11::module_& m)
       }
       return py::none();
     })
+    .def_property_readonly("id", &Parm::id)
     .def("field", py::overload_cast<std::string const&>(&Parm::getField), py::arg("name"))
     .def("__len__", &Parm::numListValues)
     .def("__getitem__", [](ParmPtr parm, size_t i) {
@@ -167,7 +168,23 @@ void bindParmToPython(pybind11::module_& m)
     .def("load", [](ParmSetPtr ps, std::string const& script){
       ps->loadScript(script);
     })
-    .def("get", py::overload_cast<std::string const&>(&ParmSet::get));
+    .def("get", py::overload_cast<std::string const&>(&ParmSet::get))
+    .def("handle", &ParmSet::handle, py::arg("path"), py::keep_alive<0, 1>())
+    .def("dirtyParmIds", &ParmSet::dirtyParmIds);
+
+  py::class_<ParmHandle>(m, "ParmHandle")
+    .def_property_readonly("id", &ParmHandle::id)
+    .def("valid", &ParmHandle::valid)
+    .def("dirty", &ParmHandle::dirty)
+    .def("value", [](ParmHandle const& h) -> py::object {
+      if (auto parm = h.ptr())
+        return parmToPy(parm);
+      return py::none();
+    })
+    .def("set", [](ParmHandle const& h, py::object val) {
+      if (auto parm = h.ptr())
+        parmFromPy(parm, val);
+    });
 
   py::class_<ParmSetInspector, std::shared_ptr<ParmSetInspector>>(m, "ParmSetInspector")
     .def_static("setFieldInspector", &ParmSetInspector::setFieldInspector, py::arg("name"), py::arg("inspect_function"))
@@ -1,7 +1,7 @@
-from nged import ItemID, ID_None, GraphTraverseResult
+from nged import ItemID, ID_None, GraphTraverseResult, requestRedraw
 from nged.msghub import trace, debug, warn, error
 from typing import Optional
-from threading import Thread  # TODO: use multiprocessing instead
+from threading import Thread  # parallel.py has a process pool backend
 from enum import Enum
 
 NodeState = Enum('NodeState', ['normal', 'dirty', 'busy', 'error', 'sourcerrror'])
@@ -49,14 +49,16 @@ class PreparedNode:
     inputs: list[int]  # index into list of PreparedNode
     parms: dict[str, any]  # freezed parm values
 
-    def __init__(self, gr: GraphTraverseResult, nodeid: ItemID):
+    def __init__(self, gr: GraphTraverseResult, nodeid: ItemID, inputs: list[int] | None = None):
         ac = gr.find(nodeid)
         self.nodeid = nodeid
         self.name = ac.node.name
         self.executor = ac.node.getExecutor()
         parms = ac.node.parm("")
         self.parms = {} if parms is None else parms.value()
-        self.inputs = [ac.inputIndex(i) for i in range(ac.inputCount)]
+        if inputs is None:
+            inputs = [ac.inputIndex(i) for i in range(ac.inputCount)]
+        self.inputs = inputs
 
 
 class PreparedGraph:
@@ -69,8 +71,11 @@ class PreparedGraph:
     def __init__(self, gr: GraphTraverseResult):
         nodes = []
         lut = {}
-        for ac in gr:
-            pnode = PreparedNode(gr, ac.node.id)
+        # slice the CSR views once instead of querying pin by pin
+        inputIndices = gr.inputIndices.tolist()
+        inputRanges = gr.inputRanges.tolist()
+        for ac, (begin, end) in zip(gr, inputRanges):
+            pnode = PreparedNode(gr, ac.node.id, inputIndices[begin:end])
             nodes.append(pnode)
             lut[ac.node.id] = pnode
         self.nodes = nodes
@@ -106,6 +111,7 @@ class GraphEvaluationContext:
     currentNode: ItemID
     evalThread: Optional[Thread]
     isPreparing: bool  # if true, the graph is being prepared, this is to avoid recursive prepare
+    backend: Optional['ProcessPoolBackend']  # see parallel.py, None to evaluate in this process only
 
     def __init__(self):
         self.destinies = set()
@@ -123,6 +129,7 @@ class GraphEvaluationContext:
         self.currentNode = ID_None
         self.evalThread = None
         self.isPreparing = False
+        self.backend = None
 
     def addDestiny(self, destiny):
         if destiny not in self.destinies:
@@ -284,6 +291,8 @@ class GraphEvaluationContext:
         if len(dirtyDestinies) > 0:
             def updateDestinies():
                 try:
+                    if self.backend is not None:
+                        self.backend.run(self, dirtyDestinies)
                     for nodeid in dirtyDestinies:
                         self.getResult(nodeid)
                 except Exception as err:
@@ -293,6 +302,7 @@ class GraphEvaluationContext:
                             self.stateCache[ac.nodeid] = NodeState.error
                 doc.readonly = False
                 self.busy = False
+                requestRedraw()  # results are in, wake up an on-demand main loop
             doc.readonly = True
             self.busy = True
             #self.evalThread = Thread(target=updateDestinies)
@@ -6,6 +6,7 @@ from document import MyDocument
 from edresponse import setupCallbacks
 from evaluation import GraphEvaluationContext
 import nodelib
+import parallel
 try:
     import libpandas
 except ImportError:
@@ -77,10 +78,24 @@ def evalGraph(view):
 
 def resetEvalContext(view):
     doc = view.doc or view.graph.doc
+    if doc.evalContext.backend is not None:
+        doc.evalContext.backend.shutdown()
     doc.evalContext = GraphEvaluationContext()
     info('graph evaluation context is reset')
 
 
+def toggleParallelEval(view):
+    doc = view.doc or view.graph.doc
+    ctx = doc.evalContext
+    if ctx.backend is None:
+        ctx.backend = parallel.ProcessPoolBackend()
+        info('graph evaluation uses worker processes')
+    else:
+        ctx.backend.shutdown()
+        ctx.backend = None
+        info('graph evaluation runs in the editor process')
+
+
 showDataCmd = makeSimpleCommand(lambda view: view.editor.addView(
     view.doc, 'data'), 'View/Data', 'Show Datasheet', 'network', 'Ctrl+Alt+D', mayModifyGraph=False)
 evalSelectedNodeCmd = makeSimpleCommand(
@@ -91,6 +106,8 @@ prepareGraphCmd = makeSimpleCommand(
     prepareGraph, 'Eval/PrepareGraph', 'Prepare Graph', 'network|inspector', 'F6')
 resetEvalContextCmd = makeSimpleCommand(
     resetEvalContext, 'Eval/ResetContext', 'Reset Evaluation Context', 'network|inspector', 'Alt+F5')
+toggleParallelEvalCmd = makeSimpleCommand(
+    toggleParallelEval, 'Eval/Parallel', 'Toggle Parallel Evaluation', 'network|inspector', mayModifyGraph=False)
 
 
 class MyApp(App):
@@ -114,6 +131,7 @@ class MyApp(App):
         self.editor.addCommand(evalGraphCmd)
         self.editor.addCommand(prepareGraphCmd)
         self.editor.addCommand(resetEvalContextCmd)
+        self.editor.addCommand(toggleParallelEvalCmd)
         self.editor.newDoc()
         setupCallbacks(self.editor)
         self.timestamp = time.process_time()
@@ -140,7 +158,10 @@ class MyApp(App):
 
     def quit(self):
         self.editor = None
+        parallel.shutdownPool()
 
 
-app = MyApp()
-startApp(app)
+# worker processes of parallel.py import this module as well, they must not start the app
+if __name__ == '__main__':
+    app = MyApp()
+    startApp(app)
@@ -3,7 +3,7 @@ from nged.msghub import trace, debug, warn, error
 from graph import MyGraph
 from icondef import *
 from evaluation import NodeState, GraphEvaluationContext, Executor, getContext
-from typing import Callable
+from typing import Callable, Optional
 
 
 class MyNodeFactory(NodeFactory):
@@ -43,6 +43,7 @@ class AdvancedFunctorExecutor(Executor):
 class ImmediateFunctorExecutor(Executor):
     '''all inputs are evaluated before calling self.func'''
     func: Callable[[list[any], dict[str, any]], any]
+    portable: Optional[tuple[str, str]] = None  # (module, node type) to find func in another process
 
     def __init__(self, nodeid, func: Callable[[list[any], dict[str, any]], any]):
         Executor.__init__(self, nodeid)
@@ -133,6 +134,13 @@ class MyNode(Node):
             canvas.drawText(self.aabb.max + Vec2(x, 0), msg, self.errorTextStyle)
 
 
+_functionNodes: dict[str, Callable] = {}  # node type -> func, of immediate function nodes
+
+
+def functionNode(nodetype: str) -> Callable:
+    return _functionNodes[nodetype]
+
+
 def register_function_as_node(desc, mode='immediate'):
     if mode == 'immediate':
         e = ImmediateFunctorExecutor
@@ -151,11 +159,15 @@ def register_function_as_node(desc, mode='immediate'):
 
             def settled(self):
                 self.executor = e(self.id, func)
+                if mode == 'immediate':
+                    self.executor.portable = (func.__module__, desc.type)
 
             def getExecutor(self):
                 return self.executor
 
         nodeFactory().register(desc, FunctorNode)
+        if mode == 'immediate':
+            _functionNodes[desc.type] = func
         return FunctorNode
 
     return func_wrapper
@@ -0,0 +1,273 @@
+'''process pool backend for GraphEvaluationContext
+
+dirty nodes whose inputs are ready are dispatched to worker processes, so CPU heavy graphs
+are not bound to one GIL; values travel as pickle protocol 5 streams whose large buffers
+(numpy arrays, pandas blocks) are placed in shared memory segments instead of the stream'''
+
+from evaluation import NodeState, GraphEvaluationContext
+from node import ImmediateFunctorExecutor, functionNode
+from nged import ItemID
+from nged.msghub import trace, error
+from concurrent.futures import ProcessPoolExecutor, FIRST_COMPLETED, wait
+from multiprocessing import get_context, resource_tracker
+from multiprocessing.shared_memory import SharedMemory
+from typing import Optional
+import importlib
+import pickle
+
+
+# ================= Shared Memory ====================
+
+
+class Packed:
+    '''a pickled value, its out-of-band buffers live at `spans` of shared memory `segment`'''
+
+    payload: bytes
+    segment: Optional[str]
+    spans: list[tuple[int, int]]  # (offset, size)
+
+    def __init__(self, payload, segment=None, spans=None):
+        self.payload = payload
+        self.segment = segment
+        self.spans = spans or []
+
+
+def _untracked(shm: SharedMemory) -> SharedMemory:
+    # segments are unlinked explicitly by whoever holds the value, the resource tracker
+    # would otherwise unlink them as soon as the worker that created them exits
+    try:
+        resource_tracker.unregister(shm._name, 'shared_memory')
+    except Exception:
+        pass
+    return shm
+
+
+def pack(value, threshold: int) -> tuple[Packed, Optional[SharedMemory]]:
+    '''pickles `value`, buffers of at least `threshold` bytes are moved into one new segment'''
+    buffers = []
+
+    def outOfBand(buf):
+        try:
+            if buf.raw().nbytes >= threshold:
+                buffers.append(buf)
+                return False
+        except BufferError:  # not contiguous, let pickle copy it
+            pass
+        return True
+
+    payload = pickle.dumps(value, protocol=5, buffer_callback=outOfBand)
+    if not buffers:
+        return Packed(payload), None
+    spans, size = [], 0
+    for buf in buffers:
+        offset = (size + 63) & ~63
+        spans.append((offset, buf.raw().nbytes))
+        size = offset + buf.raw().nbytes
+    shm = _untracked(SharedMemory(create=True, size=size))
+    for buf, (offset, nbytes) in zip(buffers, spans):
+        shm.buf[offset:offset + nbytes] = buf.raw()
+    return Packed(payload, shm.name, spans), shm
+
+
+def unpack(packed: Packed) -> tuple[any, Optional[SharedMemory]]:
+    '''the value refers to the returned segment, it stays mapped as long as the value lives'''
+    if packed.segment is None:
+        return pickle.loads(packed.payload), None
+    shm = _untracked(SharedMemory(name=packed.segment))
+    buffers = [shm.buf[offset:offset + nbytes] for offset, nbytes in packed.spans]
+    return pickle.loads(packed.payload, buffers=buffers), shm
+
+
+def _close(shm: SharedMemory) -> bool:
+    try:
+        shm.close()
+        return True
+    except BufferError:  # some value still refers to it
+        return False
+
+
+# ================= Worker ====================
+
+
+def _execute(module: str, nodetype: str, parms: dict[str, any], inputs: list[Optional[Packed]], threshold: int) -> Packed:
+    importlib.import_module(module)
+    func = functionNode(nodetype)
+    segments = []
+    values = []
+    for packed in inputs:
+        if packed is None:
+            values.append(None)
+            continue
+        value, shm = unpack(packed)
+        values.append(value)
+        if shm is not None:
+            segments.append(shm)
+    result = func(tuple(values), parms)
+    packed, shm = pack(result, threshold)
+    if shm is not None:
+        shm.close()  # the editor owns it from now on
+    del values, result
+    for shm in segments:
+        _close(shm)
+    return packed
+
+
+_pool: Optional[ProcessPoolExecutor] = None
+
+
+def sharedPool(maxWorkers: Optional[int] = None) -> ProcessPoolExecutor:
+    global _pool
+    if _pool is None:
+        # spawn: the editor process has a GL context and threads, which do not survive fork
+        _pool = ProcessPoolExecutor(max_workers=maxWorkers, mp_context=get_context('spawn'))
+    return _pool
+
+
+def shutdownPool():
+    global _pool
+    if _pool is not None:
+        _pool.shutdown(wait=False, cancel_futures=True)
+        _pool = None
+
+
+# ================= Backend ====================
+
+
+class Segment:
+    '''a value in the editor and the shared memory it was sent or received with'''
+
+    value: any
+    packed: Packed
+    shm: Optional[SharedMemory]
+
+    def __init__(self, value, packed, shm):
+        self.value = value
+        self.packed = packed
+        self.shm = shm
+
+
+class ProcessPoolBackend:
+
+    '''set as `GraphEvaluationContext.backend` to evaluate function nodes in worker processes,
+    nodes that are not registered with `register_function_as_node` (and whatever they fetch
+    lazily) still run in the editor, in between'''
+
+    threshold: int                   # buffers smaller than this are just pickled
+    segments: dict[ItemID, Segment]  # shared form of values in the context's valueCache
+    lingering: list[SharedMemory]    # released segments that are still referred to
+
+    def __init__(self, threshold: int = 1 << 16):
+        self.threshold = threshold
+        self.segments = {}
+        self.lingering = []
+
+    def release(self, segment: Segment):
+        if segment.shm is None:
+            return
+        try:
+            segment.shm.unlink()
+        except FileNotFoundError:
+            pass
+        if not _close(segment.shm):
+            self.lingering.append(segment.shm)
+
+    def keep(self, nodeid: ItemID, segment: Segment):
+        if (old := self.segments.pop(nodeid, None)) is not None:
+            self.release(old)
+        self.segments[nodeid] = segment
+
+    def collect(self, ctx: GraphEvaluationContext):
+        '''releases segments of values that are no longer cached'''
+        for nodeid in [k for k, s in self.segments.items() if ctx.valueCache.get(k, None) is not s.value]:
+            self.release(self.segments.pop(nodeid))
+        self.lingering = [shm for shm in self.lingering if not _close(shm)]
+
+    def shutdown(self):
+        for segment in self.segments.values():
+            self.release(segment)
+        self.segments = {}
+        self.lingering = [shm for shm in self.lingering if not _close(shm)]
+
+    def share(self, ctx: GraphEvaluationContext, nodeid: ItemID) -> Packed:
+        value = ctx.valueCache.get(nodeid, None)
+        if (segment := self.segments.get(nodeid, None)) is not None and segment.value is value:
+            return segment.packed
+        packed, shm = pack(value, self.threshold)
+        self.keep(nodeid, Segment(value, packed, shm))
+        return packed
+
+    def receive(self, nodeid: ItemID, packed: Packed):
+        value, shm = unpack(packed)
+        self.keep(nodeid, Segment(value, packed, shm))
+        return value
+
+    def run(self, ctx: GraphEvaluationContext, destinies: set[ItemID]):
+        '''evaluates what `destinies` need as parallel as their dependencies allow,
+        failed nodes are left dirty, for the serial pass to report them'''
+        self.collect(ctx)
+        graph = ctx.preparedGraph
+
+        def pending(nodeid):
+            return ctx.stateCache.get(nodeid, NodeState.dirty) != NodeState.normal
+
+        # only immediate executors are known to fetch all their inputs
+        deps: dict[ItemID, set[ItemID]] = {}
+        tovisit = [d for d in destinies if pending(d)]
+        while tovisit:
+            nodeid = tovisit.pop()
+            if nodeid in deps:
+                continue
+            inputs = set()
+            if isinstance(graph.getNode(nodeid).executor, ImmediateFunctorExecutor):
+                inputs = {i.nodeid for i in graph.getInputs(nodeid)
+                          if i is not None and pending(i.nodeid)}
+            deps[nodeid] = inputs
+            tovisit.extend(inputs)
+        if not any(getattr(graph.getNode(n).executor, 'portable', None) for n in deps):
+            return
+
+        dependents: dict[ItemID, list[ItemID]] = {}
+        for nodeid, inputs in deps.items():
+            for i in inputs:
+                dependents.setdefault(i, []).append(nodeid)
+        ready = [nodeid for nodeid, inputs in deps.items() if not inputs]
+        running = {}
+
+        def finish(nodeid):
+            for d in dependents.get(nodeid, []):
+                deps[d].discard(nodeid)
+                if not deps[d]:
+                    ready.append(d)
+
+        pool = sharedPool()
+        while ready or running:
+            while ready:
+                nodeid = ready.pop()
+                pnode = graph.getNode(nodeid)
+                portable = getattr(pnode.executor, 'portable', None)
+                if portable is None:
+                    try:
+                        ctx.getResult(nodeid)
+                    except Exception:
+                        continue
+                    finish(nodeid)
+                    continue
+                inputs = [self.share(ctx, i.nodeid) if i is not None else None
+                          for i in graph.getInputs(nodeid)]
+                ctx.stateCache[nodeid] = NodeState.busy
+                running[pool.submit(_execute, *portable, pnode.parms, inputs, self.threshold)] = nodeid
+            if not running:
+                break
+            done, _ = wait(running, return_when=FIRST_COMPLETED)
+            for future in done:
+                nodeid = running.pop(future)
+                pnode = graph.getNode(nodeid)
+                try:
+                    value = self.receive(nodeid, future.result())
+                except Exception as e:
+                    error(f'error evaluating {pnode.name} in worker: {e}')
+                    ctx.stateCache[nodeid] = NodeState.dirty
+                    continue
+                trace(f'eval {pnode.name} in worker -> {value}')
+                ctx.putValue(nodeid, value)
+                finish(nodeid)
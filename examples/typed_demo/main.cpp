@@ -31,9 +31,8 @@ public:
     nged::Graph* parent,
     std::string const& type,
     std::string const& name,
-    nged::Vector<nged::String> intypes,
-    nged::Vector<nged::String> outtypes
-  ) : nged::TypedNode(parent, type, name, intypes, outtypes)
+    nged::TypeSystem::PinSignature const* pins
+  ) : nged::TypedNode(parent, type, name, pins)
     , numInput(numInput)
     , numOutput(numOutput)
   {
@@ -47,6 +46,15 @@ struct DummyTypedNodeDef
   std::string type;
   int numinput, numoutput;
   nged::Vector<nged::String> intypes, outtypes;
+
+  mutable nged::TypeSystem::PinSignature const* signature = nullptr;
+
+  nged::TypeSystem::PinSignature const* pins() const
+  {
+    if (!signature)
+      signature = nged::TypeSystem::instance().pinSignature(intypes, outtypes);
+    return signature;
+  }
 };
 
 static DummyTypedNodeDef defs[] = {
@@ -77,8 +85,9 @@ class MyNodeFactory: public nged::NodeFactory
     std::string typestr(type);
     for (auto const& d: defs)
       if (d.type == type)
-        return std::make_shared<DummyTypedNode>(d.numinput, d.numoutput, parent, typestr, typestr, d.intypes, d.outtypes);
-    return std::make_shared<DummyTypedNode>(4, 1, parent, typestr, typestr, nged::Vector<nged::String>(), nged::Vector<nged::String>());
+        return std::make_shared<DummyTypedNode>(d.numinput, d.numoutput, parent, typestr, typestr, d.pins());
+    static auto const untyped = nged::TypeSystem::instance().pinSignature({}, {});
+    return std::make_shared<DummyTypedNode>(4, 1, parent, typestr, typestr, untyped);
   }
   void listNodeTypes(
       nged::Graph* graph,
@@ -17,6 +17,22 @@ public:
 
 void startApp(App* app);
 
+// Redraw {{{
+// by default the main loop renders continuously; with on-demand redraw enabled it sleeps until
+// input arrives or a redraw is requested (animations, graph changes, background jobs ...)
+void setOnDemandRedraw(bool enabled);
+bool onDemandRedraw();
+// thread safe, keeps rendering for at least `frames` more frames, wakes up the main loop if needed
+void requestRedraw(int frames = 1);
+
+namespace detail { // used by main loops
+constexpr double idleWaitTimeout = 0.5; // seconds, upper bound of a single wait
+void setRedrawWaker(void (*waker)());
+bool hasPendingRedraw();
+bool shouldRenderFrame(); // picks up input queued by ImGui, or consumes one pending redraw
+} // namespace detail
+// }}} Redraw
+
 std::wstring utf8towstring(std::string_view str);
 
 }
@@ -15,6 +15,11 @@
 
 #include <string.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GMATH_USE_SSE2 1
+#include <emmintrin.h>
+#endif
+
 namespace gmath {
 
 static constexpr double pi = 3.1415926535897932384626;
@@ -75,6 +80,7 @@ inline bool operator==(Vec2 a, Vec2 b)
          fabs(a.y - b.y) < std::numeric_limits<float>::epsilon();
 }
 inline bool operator!=(Vec2 a, Vec2 b) { return !(a == b); }
+static_assert(sizeof(Vec2) == sizeof(float) * 2, "Vec2 should be tightly packed");
 
 struct Mat3
 {
@@ -83,6 +89,7 @@ struct Mat3
   static inline Mat3 fromRTS(Vec2 scale, float rotate, Vec2 translate);
   inline Vec2        transformPoint(Vec2 v) const;
   inline Vec2        transformVec(Vec2 v) const;
+  inline void        transformPoints(Vec2 const* src, Vec2* dst, size_t count) const;
   inline float       det() const;
   inline Mat3        inverse() const;
   inline Mat3        operator*(Mat3 const& that) const;
@@ -264,6 +271,26 @@ inline Vec2 Mat3::transformPoint(Vec2 v) const
   return Vec2{x, y};
 }
 
+/// transforms `count` points from `src` into `dst`, `src` and `dst` may be the same buffer
+inline void Mat3::transformPoints(Vec2 const* src, Vec2* dst, size_t count) const
+{
+  size_t i = 0;
+#ifdef GMATH_USE_SSE2
+  // two points per register: (x0, y0, x1, y1)
+  __m128 const cx = _mm_setr_ps(m[0][0], m[0][1], m[0][0], m[0][1]);
+  __m128 const cy = _mm_setr_ps(m[1][0], m[1][1], m[1][0], m[1][1]);
+  __m128 const ct = _mm_setr_ps(m[2][0], m[2][1], m[2][0], m[2][1]);
+  for (; i + 2 <= count; i += 2) {
+    __m128 const p  = _mm_loadu_ps(&src[i].x);
+    __m128 const xx = _mm_shuffle_ps(p, p, _MM_SHUFFLE(2, 2, 0, 0));
+    __m128 const yy = _mm_shuffle_ps(p, p, _MM_SHUFFLE(3, 3, 1, 1));
+    _mm_storeu_ps(&dst[i].x, _mm_add_ps(_mm_add_ps(_mm_mul_ps(xx, cx), _mm_mul_ps(yy, cy)), ct));
+  }
+#endif
+  for (; i < count; ++i)
+    dst[i] = transformPoint(src[i]);
+}
+
 inline Vec2 Mat3::transformVec(Vec2 v) const
 {
   float x = v.x * m[0][0] + v.y * m[1][0];
@@ -8,6 +8,7 @@
 #include <phmap.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <chrono>
 #include <cmath>
@@ -17,6 +18,7 @@
 #include <limits>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <random>
 #include <set>
@@ -219,13 +221,31 @@ public:
   };
 
   void addMessage(String message, Category category, Verbosity verbose);
+  /// moves pending messages into the hub and forwards log messages to spdlog,
+  /// the editor calls this once per frame, headless users should call it periodically
+  void flush() const { collect(); }
   void clear(Category category);
   void clearAll();
   void setCountLimit(size_t count);
+  /// log messages less verbose than `verbosity` are dropped before being formatted,
+  /// defaults to `Info`, or `Trace` in DEBUG builds
+  void setMinVerbosity(Verbosity verbosity)
+  {
+    minVerbosity_.store(verbosity, std::memory_order_relaxed);
+  }
+  Verbosity minVerbosity() const { return minVerbosity_.load(std::memory_order_relaxed); }
+  /// called from the producing thread after each accepted message, the editor sets it to
+  /// `requestRedraw()` so messages from background work wake up an on-demand main loop
+  void      setNotifier(void (*notifier)()) { notifier_.store(notifier, std::memory_order_relaxed); }
+  bool      accepts(Category category, Verbosity verbosity) const
+  {
+    return category != Category::Log || verbosity >= minVerbosity();
+  }
 
   template<class F>
   void foreach (Category category, F && func) const
   {
+    collect();
     std::shared_lock lock(mutex_);
     for (auto&& s : messageCategories_[static_cast<int>(category)]) {
       func(s);
@@ -234,6 +254,7 @@ public:
   template<class F>
   void forrange(Category category, F&& func, size_t offset, size_t count = -1) const
   {
+    collect();
     std::shared_lock lock(mutex_);
     auto const&      queue = messageCategories_[static_cast<int>(category)];
     for (size_t i = offset,
@@ -243,8 +264,20 @@ public:
       func(queue[i]);
     }
   }
+  /// calls `func(messages, first)` with the message deque of `category` under the read lock,
+  /// `first` is the serial of `messages.front()`: how many messages of this category
+  /// have been evicted or cleared before it
+  template<class F>
+  void view(Category category, F&& func) const
+  {
+    collect();
+    std::shared_lock lock(mutex_);
+    func(
+      messageCategories_[static_cast<int>(category)], evicted_[static_cast<int>(category)]);
+  }
   size_t count(Category category) const
   {
+    collect();
     std::shared_lock lock(mutex_);
     return messageCategories_[static_cast<int>(category)].size();
   }
@@ -252,9 +285,53 @@ public:
   static MessageHub& instance() { return instance_; }
 
 protected:
-  std::deque<Message>       messageCategories_[static_cast<int>(Category::Count)];
-  mutable std::shared_mutex mutex_;
-  size_t                    countLimit_ = 4096;
+  // bounded multi-producer queue (Vyukov style), producers never lock,
+  // pops are serialized by `drainMutex_`
+  class Ring
+  {
+  public:
+    static constexpr size_t capacity = 1024; // power of two
+
+    Ring();
+    bool push(String& content, Verbosity verbosity, TimePoint time);
+    bool pop(std::deque<Message>& into);
+    bool empty() const;
+
+  private:
+    struct Slot
+    {
+      std::atomic<size_t> sequence;
+      String              content;
+      Verbosity           verbosity;
+      TimePoint           timestamp;
+    };
+    std::unique_ptr<Slot[]> slots_;
+    alignas(64) std::atomic<size_t> tail_ = 0;
+    alignas(64) std::atomic<size_t> head_ = 0;
+  };
+
+  /// moves pending messages from the rings into `messageCategories_`,
+  /// then writes the new log messages to spdlog
+  void collect() const;
+  /// producer side of a full ring: moves its content into `overflow_`,
+  /// never touches `mutex_`, so producers never wait for readers of the hub
+  void drain(int category) const;
+
+  mutable Ring                rings_[static_cast<int>(Category::Count)];
+  mutable std::deque<Message> overflow_[static_cast<int>(Category::Count)];
+  mutable size_t              overflowEvicted_[static_cast<int>(Category::Count)] = {0};
+  mutable std::atomic<bool>   hasOverflow_ = false;
+  mutable std::mutex          drainMutex_; // guards ring pops and `overflow_`, held briefly
+  mutable std::deque<Message> messageCategories_[static_cast<int>(Category::Count)];
+  mutable size_t              evicted_[static_cast<int>(Category::Count)] = {0};
+  mutable std::shared_mutex   mutex_;
+  std::atomic<size_t>         countLimit_ = 4096;
+  std::atomic<void (*)()>     notifier_   = nullptr;
+#ifdef DEBUG
+  std::atomic<Verbosity> minVerbosity_ = Verbosity::Trace;
+#else
+  std::atomic<Verbosity> minVerbosity_ = Verbosity::Info;
+#endif
 
   static MessageHub instance_;
 
@@ -266,11 +343,16 @@ public: // helpers
 #define EMIT_MESSAGE_(msg, cat, verb) \
   MessageHub::instance().addMessage((msg), Category::cat, Verbosity::verb)
 #define DEFINE_MSG_VARIANT_(func, cat, verb)                                        \
-  static inline void func(String msg) { EMIT_MESSAGE_(std::move(msg), cat, verb); } \
+  static inline void func(StringView msg)                                           \
+  {                                                                                 \
+    if (MessageHub::instance().accepts(Category::cat, Verbosity::verb))             \
+      EMIT_MESSAGE_(String(msg), cat, verb);                                        \
+  }                                                                                 \
   template<class... T>                                                              \
   static inline void func##f(T... args)                                             \
   {                                                                                 \
-    EMIT_MESSAGE_(fmt::format(std::forward<T>(args)...), cat, verb);                \
+    if (MessageHub::instance().accepts(Category::cat, Verbosity::verb))             \
+      EMIT_MESSAGE_(fmt::format(std::forward<T>(args)...), cat, verb);              \
   }
   DEFINE_MSG_VARIANT_(trace, Log, Trace)
   DEFINE_MSG_VARIANT_(debug, Log, Debug)
@@ -350,6 +432,7 @@ public:
   virtual bool moveTo(Vec2 to)
   {
     pos_ = to; // Vec2(std::round(to.x), std::round(to.y));
+    syncHotFields();
     return true;
   }
 
@@ -364,8 +447,15 @@ public:
   UID  sourceUID() const { return sourceUID_; }
 
   /// for culling and _broad phase_ hit test
+  ///
+  /// graphs cull and pick from a cached copy of `aabb()`: an item whose local bound changes
+  /// other than through `moveTo()` must call `syncHotFields()`, or it is drawn and picked at
+  /// its old bound until the next history commit, which refreshes every cached bound.
+  /// DEBUG builds assert the cache is fresh in `Graph::itemsInBound()`
   virtual AABB localBound() const { return aabb_; }
   AABB         aabb() const { return localBound().moved(pos_); }
+  /// push pos / bounds into the hot tables of item pool, call it whenever they change
+  void         syncHotFields() const;
   Vec2         pos() const { return pos_; }
 
   /// parent graph, can be nullptr for root node
@@ -577,25 +667,58 @@ public:
 
 class TypeSystem
 {
-  Vector<String>        types_;
-  sint                  nextTypeIndex_ = 0;
-  HashMap<String, sint> typeIndex_;
-  HashMap<String, sint> typeBaseType_;
+public:
+  using TypeIndex = sint;
+  /// pin types of a typed node, shared by all nodes having the same ones
+  struct PinSignature
+  {
+    Vector<TypeIndex> inputs;
+    Vector<TypeIndex> outputs;
+  };
+
+private:
+  std::deque<String>     types_; // deque: `typeName()` views stay valid
+  sint                   nextTypeIndex_ = 0;
+  HashMap<String, sint>  typeIndex_;
+  HashMap<String, sint>  typeBaseType_;
   HashMap<std::pair<sint, sint>, bool> typeConvertable_;
-  HashMap<sint, Color>  typeColorHints_;
+  Vector<Optional<Color>> typeColorHints_; // by TypeIndex
+
+  std::deque<PinSignature>              signatures_;
+  HashMap<String, PinSignature const*>  signatureIndex_; // joined type names -> signature
+
+  // transitive closure of `typeConvertable_`, row `from` has bit `to` set if convertable;
+  // rebuilt on first query after `registerType` / `setConvertable`
+  mutable Vector<uint64_t>  closure_;
+  mutable size_t            closureStride_ = 0; // uint64_t words per row
+  mutable std::atomic<bool> closureDirty_  = true;
+  mutable std::mutex        closureMutex_;
+  void                      rebuildClosure() const;
 
   TypeSystem() = default;
   TypeSystem(TypeSystem const&) = delete;
 
 public:
   ~TypeSystem() = default;
-  using TypeIndex = sint;
   static constexpr TypeIndex InvalidTypeIndex = -1;
   static TypeSystem& instance();
 
   TypeIndex       registerType(StringView type, StringView baseType="", Color hintColor=Color{0,0,0,0});
   void            setConvertable(StringView from, StringView to, bool convertable = true);
+  /// `from` converts to `to` if they are the same, if `to` is "any" or "*", or if there is a
+  /// chain of base types / `setConvertable` from one to the other, that is not explicitly
+  /// denied by `setConvertable(from, to, false)`
   bool            isConvertable(StringView from, StringView to) const;
+  bool            isConvertable(TypeIndex from, TypeIndex to) const
+  {
+    if (from < 0 || to < 0)
+      return false;
+    if (closureDirty_.load(std::memory_order_acquire))
+      rebuildClosure();
+    if (size_t(from) >= types_.size() || size_t(to) >= types_.size())
+      return false;
+    return (closure_[from * closureStride_ + (to >> 6)] >> (to & 63)) & 1;
+  }
   bool            isType(StringView type) const;
   TypeIndex       typeIndex(StringView type) const;
   sint            typeCount() const;
@@ -605,23 +728,62 @@ public:
   Optional<Color> colorHint(TypeIndex index) const;
   void            setColorHint(StringView type, Color hint) { setColorHint(typeIndex(type), hint); }
   Optional<Color> colorHint(StringView type) const { return colorHint(typeIndex(type)); }
+  /// registers all types named and returns the (interned) signature made of them,
+  /// it lives as long as the type system
+  PinSignature const* pinSignature(Vector<String> const& inputs, Vector<String> const& outputs);
 };
 
 /// Node with type checking, accept input only if `typeConvertable(sourceNode->outputType(sourcePort), inputType(port))` returns true
 class TypedNode : public Node
 {
 protected:
-  Vector<String> inputTypes_;
-  Vector<String> outputTypes_;
+  /// read-only view of the type names of one side of `pins_`, stands in for the string vectors
+  /// TypedNode used to have, so `inputTypes_.size()` / `inputTypes_[i]` in subclasses still work
+  class PinTypeNames
+  {
+    Vector<TypeSystem::TypeIndex> const* types_ = nullptr;
+
+  public:
+    PinTypeNames() = default;
+    explicit PinTypeNames(Vector<TypeSystem::TypeIndex> const& types): types_(&types) {}
+
+    size_t     size() const { return types_ ? types_->size() : 0; }
+    bool       empty() const { return size() == 0; }
+    StringView operator[](size_t i) const { return TypeSystem::instance().typeName((*types_)[i]); }
+  };
+
+  TypeSystem::PinSignature const* pins_; // shared with other nodes of the same pin types
+  PinTypeNames                    inputTypes_;
+  PinTypeNames                    outputTypes_;
 
 public:
-  TypedNode(Graph* parent, String type, String name, Vector<String> inputTypes, Vector<String> outputTypes):
+  TypedNode(Graph* parent, String type, String name, TypeSystem::PinSignature const* pins):
     Node(parent, type, name)
   {
-    inputTypes_ = std::move(inputTypes);
-    outputTypes_ = std::move(outputTypes);
+    setPinSignature(pins);
+  }
+  TypedNode(Graph* parent, String type, String name, Vector<String> const& inputTypes, Vector<String> const& outputTypes):
+    TypedNode(parent, type, name, TypeSystem::instance().pinSignature(inputTypes, outputTypes))
+  {
+  }
+
+  TypeSystem::PinSignature const& pinSignature() const { return *pins_; }
+  void setPinSignature(TypeSystem::PinSignature const* pins)
+  {
+    assert(pins);
+    pins_        = pins;
+    inputTypes_  = PinTypeNames(pins->inputs);
+    outputTypes_ = PinTypeNames(pins->outputs);
   }
 
+  TypeSystem::TypeIndex inputTypeIndex(sint i) const
+  {
+    return i >= 0 && size_t(i) < pins_->inputs.size() ? pins_->inputs[i] : TypeSystem::InvalidTypeIndex;
+  }
+  TypeSystem::TypeIndex outputTypeIndex(sint i) const
+  {
+    return i >= 0 && size_t(i) < pins_->outputs.size() ? pins_->outputs[i] : TypeSystem::InvalidTypeIndex;
+  }
   StringView inputType(sint i) const;
   StringView outputType(sint i) const;
 
@@ -752,6 +914,7 @@ public:
   {
     moveTo(absoluteBounds.center());
     aabb_ = absoluteBounds.moved(-pos_);
+    syncHotFields();
   }
 
   virtual ResizableBox* asResizable() override { return this; }
@@ -870,8 +1033,8 @@ public:
 
   Vec2  start() const { return start_ + pos_; }
   Vec2  end() const { return end_ + pos_; }
-  void  setStart(Vec2 p) { start_ = p - pos_; }
-  void  setEnd(Vec2 p) { end_ = p - pos_; }
+  void  setStart(Vec2 p) { start_ = p - pos_; syncHotFields(); }
+  void  setEnd(Vec2 p) { end_ = p - pos_; syncHotFields(); }
   float thickness() const { return thickness_; }
   void  setThickness(float t) { thickness_ = t; }
   float tipSize() const { return tipSize_; }
@@ -885,6 +1048,7 @@ class GraphTraverseResult
 {
   friend class Graph;
 
+public:
   struct Range
   {
     size_t begin = -1, end = -1;
@@ -905,10 +1069,18 @@ protected:
                            // closures_[0].outputs == {2,3} then the output of nodes_[0] is
                            // nodes_[1]
   Vector<NodePtr>         nodes_;
+  Vector<ItemID>          ids_; // ids of nodes_
   Vector<NodeClosure>     closures_;
   HashMap<ItemID, size_t> idmap_; // map id to accessor
 
 public:
+  // raw CSR storage, for exporting in bulk
+  // missing inputs are stored as `size_t(-1)`
+  Vector<size_t> const&      inputIndices() const { return inputs_; }
+  Vector<size_t> const&      outputIndices() const { return outputs_; }
+  Vector<ItemID> const&      nodeIds() const { return ids_; }
+  Vector<NodeClosure> const& closures() const { return closures_; }
+
   size_t size() const { return closures_.size(); }
   size_t count() const { return closures_.size(); }
   Node*  node(size_t nthNode) const { return nodes_[nthNode].get(); }
@@ -1063,13 +1235,37 @@ public:
   virtual ItemID       add(GraphItemPtr item);
   virtual GraphItemPtr get(ItemID id) const;
   virtual GraphItemPtr tryGet(ItemID id) const;
+  /// non-owning, refcount-free variants of get / tryGet:
+  /// the pointer is valid until the item is removed from the graph, do not keep it across
+  /// graph modifications or frames, take a `GraphItemPtr` from `get()` for that
+  GraphItem* getRaw(ItemID id) const;
+  GraphItem* tryGetRaw(ItemID id) const;
   virtual bool    move(HashSet<ItemID> const& items, Vec2 const& delta); // return : anything moved
+  /// moves `items[i]` to `positions[i]` in one edit group, link paths are updated once for all;
+  /// ids not in this graph are skipped, return : number of items moved
+  size_t setPositions(Vector<ItemID> const& items, Vector<Vec2> const& positions);
   virtual void    remove(HashSet<ItemID> const& items);
   virtual void    clear();
   virtual bool    checkLinkIsAllowed(ItemID sourceItem, sint sourcePort, ItemID destItem, sint destPort, NodePin* errorPin = nullptr); // check if sourceItem, sourcePort can connect to destItem, destPort; if not, the refusing-to-connect pin will be returned via last argument
   virtual LinkPtr setLink(ItemID sourceItem, sint sourcePort, ItemID destItem, sint destPort);
   virtual void    removeLink(ItemID destItem, sint destPort);
 
+  struct BulkLink
+  {
+    sint sourceNode, sourcePort; // index into nodes being added
+    sint destNode, destPort;     // destPort < 0 appends to variadic inputs
+  };
+  /// creates nodes of `types` (placed at `positions`, if given) and links them, all in one edit
+  /// group and one modification notice, ids of failed nodes / links are ID_None (a node fails
+  /// if the factory returns null or throws);
+  /// links are validated by `checkLinkIsAllowed()` but do not go through `setLink()`
+  bool addBulk(
+    Vector<String> const&   types,
+    Vector<Vec2> const&     positions,
+    Vector<BulkLink> const& links,
+    Vector<ItemID>&         nodeIds,
+    Vector<ItemID>&         linkIds);
+
   bool checkLoopBottomUp(
     ItemID           target,
     Vector<ItemID>&  loop,
@@ -1112,6 +1308,27 @@ public:
       func(std::static_pointer_cast<Link>(linkitem));
     }
   }
+  /// same as forEachItem / forEachLink, but passes raw pointers (see `getRaw()` for lifetime);
+  /// `func` must not add or remove items while iterating
+  template<class F>
+  inline void forEachItemRaw(F&& func) const
+  {
+    for (auto id : items_) {
+      func(getRaw(id));
+    }
+  }
+  template<class F>
+  inline void forEachLinkRaw(F&& func) const
+  {
+    for (auto linkpair : linkIDs_) {
+      func(static_cast<Link*>(getRaw(linkpair.second)));
+    }
+  }
+  /// collects items whose bounds intersects `region`, scans the hot tables of item pool instead
+  /// of touching every item; pointers are only valid until the graph is modified
+  void itemsInBound(AABB const& region, Vector<GraphItem*>& result) const;
+  /// union of all item bounds, from the hot tables as well
+  AABB itemsBound() const;
 
   virtual NodeFactory const* nodeFactory() const;
   /// calculates a path from start to end
@@ -1128,13 +1345,42 @@ public:
 // }}} Graph
 
 // Pool {{{
+enum class ItemKind : uint8_t
+{
+  None = 0, // empty slot
+  Node,
+  Link,
+  Router,
+  GroupBox,
+  Resizable,
+  Other
+};
+
 class GraphItemPool
 {
+public:
+  /// frequently scanned fields of every slot, struct-of-arrays indexed by `ItemID::index()`
+  struct HotFields
+  {
+    Vector<ItemID>     id;     // ID_None for empty slots
+    Vector<GraphItem*> item;   // non-owning
+    Vector<Graph*>     parent;
+    Vector<Vec2>       pos;
+    Vector<AABB>       bounds; // world space, cached `aabb()`
+    Vector<ItemKind>   kind;
+
+    size_t size() const { return id.size(); }
+  };
+
+private:
   Vector<GraphItemPtr> items_;
   Vector<uint32_t>     freeList_;
   HashMap<UID, ItemID> uidMap_;
+  HotFields            hot_;
   std::mt19937         randGenerator_;
 
+  void resetHotFields(ItemID id, GraphItem const* item); // item == nullptr to clear the slot
+
   GraphItemPool(GraphItemPool const&) = delete;
   GraphItemPool(GraphItemPool&&) = delete;
 
@@ -1153,6 +1399,7 @@ public:
     uidMap_.erase(item->uid());
     freeList_.push_back(index);
     items_[index] = nullptr;
+    resetHotFields(id, nullptr);
   }
   GraphItemPtr get(ItemID id)
   {
@@ -1166,6 +1413,17 @@ public:
       return nullptr;
     return itemptr;
   }
+  GraphItem* getRaw(ItemID id) const
+  {
+    auto index = id.index();
+    if (id == ID_None)
+      return nullptr;
+    assert(index < items_.size());
+    auto* itemptr = items_[index].get();
+    if (!itemptr || itemptr->id() != id)
+      return nullptr;
+    return itemptr;
+  }
   GraphItemPtr get(UID const& uid)
   {
     if (auto itr = uidMap_.find(uid); itr != uidMap_.end())
@@ -1173,6 +1431,9 @@ public:
     return nullptr;
   }
   void moveUID(UID const& oldUID, UID const& newUID);
+  /// refresh pos / bounds of a living item
+  void syncHotFields(GraphItem const* item);
+  HotFields const& hotFields() const { return hot_; }
   template<class F>
   void foreach (F f) const
   {
@@ -1187,6 +1448,54 @@ public:
 };
 // }}} Pool
 
+// Search Index {{{
+/// search keys (label, or else name, or else type) of the nodes in every graph of a document,
+/// kept up to date on add, remove, rename and history commit; `candidates()` only narrows a
+/// search down, callers still score or verify what it returns
+class NodeSearchIndex
+{
+public:
+  struct Entry
+  {
+    ItemID   id;
+    String   key;
+    uint64_t chars = 0; // one bit per (lower-cased) character class, see `charMask()`
+  };
+  using Snapshot = std::shared_ptr<Vector<Entry> const>;
+
+private:
+  Vector<Entry>                      entries_;  // dense, removal moves the last one in
+  HashMap<ItemID, size_t>            slots_;    // id -> index into `entries_`
+  HashMap<uint32_t, HashSet<ItemID>> trigrams_; // lower-cased trigram -> ids
+  mutable Snapshot                   snapshot_; // copy of `entries_`, dropped when they change
+
+  void unindex(Entry const& entry);
+
+public:
+  static String   keyOf(Node const* node);
+  static uint64_t charMask(StringView str);
+  /// whether `entry` can match `pattern`, the per entry part of `candidates()`,
+  /// `chars` is `charMask(pattern)`
+  static bool     accepts(Entry const& entry, StringView pattern, uint64_t chars, bool subsequence);
+
+  void   update(ItemID id, Node const* node);
+  void   remove(ItemID id);
+  void   clear();
+  size_t size() const { return entries_.size(); }
+  /// immutable copy of the entries, shared until the index changes, so a search can run on
+  /// another thread without copying keys per query
+  Snapshot snapshot() const;
+  /// narrows `pattern` down to indices into `snapshot()` through the trigram index,
+  /// returns false if it cannot (short pattern or `subsequence`), then every entry is a candidate;
+  /// the indices still need `accepts()`
+  bool     narrow(StringView pattern, bool subsequence, Vector<uint32_t>& slots) const;
+  /// appends to `out` the entries that can match `pattern`: if `subsequence`, those having
+  /// all characters of it (what fuzzy matching needs), otherwise those having it as a
+  /// case-insensitive substring
+  void     candidates(StringView pattern, bool subsequence, Vector<Entry>& out) const;
+};
+// }}} Search Index
+
 // Doc {{{
 class NodeGraphEditor;
 class NodeGraphDocHistory
@@ -1264,6 +1573,7 @@ public:
 class NodeGraphDoc : public std::enable_shared_from_this<NodeGraphDoc>
 {
   GraphItemPool       pool_;
+  NodeSearchIndex     searchIndex_;
   NodeGraphDocHistory history_;
   String              savePath_ = "";
   String              title_    = "untitled";
@@ -1271,11 +1581,28 @@ class NodeGraphDoc : public std::enable_shared_from_this<NodeGraphDoc>
   bool                readonly_ = false;
   bool                deserializeInplace_ =
     true; // if true, uid will be used for match items in place, otherwise, uids will be new
+  bool binarySerialization_ = false; // see `binarySerialization()`
   GraphItemFactory const* itemFactory_ = nullptr;
   NodeFactoryPtr          nodeFactory_;
 
   std::function<void(Graph*)> graphModifiedNotifier_;
-  
+  int32_t                     deferModifiedLevel_ = 0;
+  Vector<Graph*>              deferredModified_; // graphs to notify when leaving level 0
+
+  class DeferModifiedNotify
+  {
+    NodeGraphDoc* doc_;
+
+  public:
+    DeferModifiedNotify(NodeGraphDoc* doc) : doc_(doc) { ++doc_->deferModifiedLevel_; }
+    ~DeferModifiedNotify()
+    {
+      if (--doc_->deferModifiedLevel_ == 0)
+        doc_->flushModifiedNotify();
+    }
+  }; // every modified graph is notified once when leaving the outermost scope
+  void flushModifiedNotify();
+
 protected:
   GraphPtr       root_ = nullptr;
   GraphItemPool& itemPool() { return pool_; }
@@ -1290,11 +1617,24 @@ public:
   virtual String filterFileInput(StringView fileContent) { return String(fileContent); }
   virtual String filterFileOutput(StringView fileContent) { return String(fileContent); }
 
-  virtual ItemID       addItem(GraphItemPtr item) { return pool_.add(std::move(item)); }
+  virtual ItemID       addItem(GraphItemPtr item);
   virtual GraphItemPtr getItem(ItemID id) { return pool_.get(id); }
-  virtual void         removeItem(ItemID id) { pool_.release(id); }
+  GraphItem*           getItemRaw(ItemID id) const { return pool_.getRaw(id); }
+  virtual void         removeItem(ItemID id);
   virtual size_t       numItems() const { return pool_.count(); }
   virtual void moveUID(UID const& oldUID, UID const& newUID) { pool_.moveUID(oldUID, newUID); }
+  void                 syncItemHotFields(GraphItem const* item) { pool_.syncHotFields(item); }
+  GraphItemPool const& pool() const { return pool_; }
+  /// call after renaming a node (or changing whatever its `label()` shows), to see it in search
+  /// results before the next history commit
+  void                   updateSearchKey(GraphItem const* item);
+  /// re-reads the search keys of all nodes, done on every history commit, so that labels
+  /// derived from parms or other node state do not go stale
+  void                   refreshSearchKeys();
+  /// re-reads the cached bounds of all items, done on every history commit as a safety net
+  /// for items that changed their bound without `GraphItem::syncHotFields()`
+  void                   refreshHotFields();
+  NodeSearchIndex const& searchIndex() const { return searchIndex_; }
   virtual void makeRoot();
 
   NodeGraphDoc(NodeFactoryPtr nodeFactory, GraphItemFactory const* itemFactory);
@@ -1327,13 +1667,22 @@ public:
 
   void setDeserializeInplace(bool dsi) { deserializeInplace_ = dsi; }
   bool deserializeInplace() const { return deserializeInplace_; }
+  /// true while the doc is (de)serialized into a binary container (history versions),
+  /// items may store `Json::binary` blobs then; text files and clipboard always get plain JSON
+  void setBinarySerialization(bool binary) { binarySerialization_ = binary; }
+  bool binarySerialization() const { return binarySerialization_; }
   auto editGroup(String message) { return history_.editGroup(std::move(message)); }
+  /// whole-document (de)serialization (files, history versions) goes through these,
+  /// subclasses may batch per-item work around them
+  virtual bool serializeGraph(Graph const* graph, Json& json) { return graph->serialize(json); }
+  virtual bool deserializeGraph(Graph* graph, Json const& json) { return graph->deserialize(json); }
 
   void setModifiedNotifier(std::function<void(Graph*)> func)
   {
     graphModifiedNotifier_ = std::move(func);
   }
   void notifyGraphModified(Graph* graph);
+  DeferModifiedNotify deferModifiedNotify() { return DeferModifiedNotify(this); }
 };
 // }}} Doc
 
@@ -1391,6 +1740,12 @@ public:
     uint32_t strokeColor; // RGBA
   };
   static constexpr ShapeStyle defaultShapeStyle = {true, 0xff0000ff, 0.f, 0xffffffff};
+  struct PolyRange
+  {
+    sint offset; // first point in the shared point buffer
+    sint count;
+    bool closed;
+  };
   struct TextStyle
   {
     TextAlign         align;
@@ -1494,6 +1849,31 @@ public:
     sint        numpt,
     bool        closed = true,
     ShapeStyle  style  = defaultShapeStyle) const = 0;
+
+  // batched primitives:
+  // `styles` has either `numStyles == 1` (shared by all primitives) or one style per primitive.
+  // the default implementations fall back to the single-primitive calls above.
+  virtual void drawRects(
+    AABB const*       rects,
+    sint              count,
+    float             cornerradius,
+    ShapeStyle const* styles,
+    sint              numStyles = 1) const;
+  virtual void drawCircles(
+    Vec2 const*       centers,
+    sint              count,
+    float             radius,
+    int               nsegments,
+    ShapeStyle const* styles,
+    sint              numStyles = 1) const;
+  // draws `npoly` polylines, each one is a range in the shared `pts` buffer
+  virtual void drawPolylines(
+    Vec2 const*       pts,
+    PolyRange const*  polys,
+    sint              npoly,
+    ShapeStyle const* styles,
+    sint              numStyles = 1) const;
+
   virtual void drawText(Vec2 pos, StringView text, TextStyle const& style = defaultTextStyle)
     const = 0;
   virtual void drawTextUntransformed(
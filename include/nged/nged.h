@@ -120,11 +120,38 @@ public:
   };
   using InteractionStatePtr = std::shared_ptr<InteractionState>;
 
+  // shapes collected from all effects in a frame, drawn after them with one call per kind
+  struct EffectBatch
+  {
+    struct Text
+    {
+      Vec2              pos;
+      String            text;
+      Canvas::TextStyle style;
+    };
+    static constexpr float boxRadius = 4.f;
+
+    Vector<AABB>               boxes;
+    Vector<Canvas::ShapeStyle> boxStyles; // one per box
+    Vector<Text>               texts;     // drawn above the boxes
+
+    void clear()
+    {
+      boxes.clear();
+      boxStyles.clear();
+      texts.clear();
+    }
+  };
   class Effect
   {
   public:
     virtual ~Effect() {}
-    virtual void updateAndDraw(Canvas* canvas, float dt) = 0;
+    virtual void updateAndDraw(Canvas* canvas, float dt) {}
+    // effects made of boxes and texts can add them to `batch` instead of drawing them directly
+    virtual void updateAndDraw(Canvas* canvas, float dt, EffectBatch& batch)
+    {
+      updateAndDraw(canvas, dt);
+    }
     virtual bool alive() const { return false; } // will be removed once dead
   };
   class FadingText : public Effect
@@ -143,7 +170,8 @@ public:
       duration_(duration),
       age_(0.f)
     { }
-    void updateAndDraw(Canvas* canvas, float dt) override
+    using Effect::updateAndDraw;
+    void updateAndDraw(Canvas* canvas, float dt, EffectBatch& batch) override
     {
       age_ += dt;
       float t = gmath::clamp(age_/duration_, 0.f, 1.f);
@@ -161,8 +189,9 @@ public:
         2.f,  toUint32RGBA(color_)
       };
       auto halfSize = canvas->measureTextSize(text_, style)*0.5f+Vec2{16,8};
-      canvas->drawRect(pos_ - halfSize, pos_ + halfSize, 4.f, bgstyle);
-      canvas->drawText(pos_, text_, style);
+      batch.boxes.push_back(AABB(pos_ - halfSize, pos_ + halfSize));
+      batch.boxStyles.push_back(bgstyle);
+      batch.texts.push_back({pos_, text_, style});
     }
     bool alive() const override
     {
@@ -185,9 +214,16 @@ public:
     Up, Down, Left, Right
   };
 
+  struct FrameTime
+  {
+    double update = 0; // seconds
+    double draw   = 0; // seconds
+  };
+
 protected:
   std::unique_ptr<Canvas> canvas_ = {nullptr};
   Vector<std::unique_ptr<Effect>> effects_;
+  EffectBatch                     effectBatch_;
 
   bool            canvasIsFocused_ = false;
   HashSet<ItemID> selectedItems_   = {};
@@ -211,6 +247,8 @@ protected:
   // so we use phmap::flat_hash_map for now.
   HashMap<String, InteractionStatePtr> stateTypeMap_ = {};
 
+  FrameTime frameTime_; // of the last update() & draw()
+
   void updateAndDrawEffects(float dt);
 
 public:
@@ -220,6 +258,7 @@ public:
   virtual void postInit() override { initInteractionStates(); }
 
   Canvas*     canvas() const { return canvas_.get(); }
+  auto const& frameTime() const { return frameTime_; }
   bool        canvasIsFocused() const { return canvasIsFocused_; }
   void        setCanvasIsFocused(bool f) { canvasIsFocused_ = f; }
   auto const& selectedItems() const { return selectedItems_; }
@@ -562,6 +601,7 @@ class NodeGraphEditor
 public:
   using DocPtr  = std::shared_ptr<NodeGraphDoc>;
   using ViewPtr = std::shared_ptr<GraphView>;
+  NodeGraphEditor();
   virtual ~NodeGraphEditor() { }
 
   struct ContextMenuEntry
@@ -336,8 +336,9 @@ class CreateNodeState : public NetworkView::NamedInteractionState<CreateNodeStat
   };
 
   String                           input_ = "";
-  std::multimap<int, MatchItem,
-                std::greater<int>> orderedMatches_; // edit distance -> string
+  Vector<MatchItem>                candidates_;   // items then node types, listed on enter
+  String                           matchedInput_; // what `matches_` were scored against
+  Vector<std::pair<int, uint32_t>> matches_;      // score, index into `candidates_`; best first
 
   GraphItemPtr pendingItemToPlace_;
   ItemID       hiddenLink_;
@@ -351,9 +352,6 @@ class CreateNodeState : public NetworkView::NamedInteractionState<CreateNodeStat
   mutable OutputConnection pendingOutputLink_;
   mutable bool             manualActivated_ = false;
 
-  // for sorting
-  int tempCounter_ = 0;
-
 public:
   static constexpr StringView className = "create-node";
 
@@ -0,0 +1,84 @@
+/// CPU rasterizing Canvas, renders into an RGBA buffer without any GPU or ImGui context
+/// useful for thumbnails, batch jobs and headless benchmarks
+#pragma once
+#include "ngdoc.h"
+
+namespace nged {
+
+// Raster Canvas {{{
+class RasterCanvas : public Canvas
+{
+public:
+  class RasterImage : public Canvas::Image
+  {
+  public:
+    int             width  = 0;
+    int             height = 0;
+    Vector<uint8_t> pixels; // RGBA, 8-bit per channel
+  };
+
+  RasterCanvas(int width = 800, int height = 600);
+  ~RasterCanvas();
+
+  int            width() const { return width_; }
+  int            height() const { return height_; }
+  uint8_t const* pixels() const { return pixels_.data(); } // RGBA, 8-bit per channel, row major
+
+  void resize(int width, int height);
+  /// clears the pixels and all pending primitives
+  void beginFrame(uint32_t clearColor = 0x000000ff);
+  /// rasterizes pending primitives, layer by layer
+  void endFrame();
+
+  /// encodes current pixels as PNG
+  Vector<uint8_t> encodePNG() const;
+  bool            savePNG(String const& path) const;
+
+  /// `Canvas::createImage` lives with the GPU backend, images drawn on RasterCanvas must be
+  /// created here, other images are drawn as placeholders
+  static ImagePtr createRasterImage(uint8_t const* data, int width, int height);
+
+  /// fits `graph` into the canvas and draws all its items (thumbnail style, no view states)
+  void drawGraph(Graph* graph, float margin = 32.f);
+
+  // Canvas interface
+  Vec2 measureTextSize(StringView text, TextStyle const& style = defaultTextStyle) const override;
+  void setCurrentLayer(Layer layer) override;
+  void drawLine(Vec2 a, Vec2 b, uint32_t color, float width) const override;
+  void drawRect(Vec2 topleft, Vec2 bottomright, float cornerradius, ShapeStyle style)
+    const override;
+  void drawCircle(Vec2 center, float radius, int nsegments, ShapeStyle style) const override;
+  void drawPoly(Vec2 const* pts, sint numpt, bool closed, ShapeStyle style) const override;
+  void drawText(Vec2 pos, StringView text, TextStyle const& style) const override;
+  void drawTextUntransformed(Vec2 pos, StringView text, TextStyle const& style, float scale)
+    const override;
+  void drawImage(ImagePtr image, Vec2 pmin, Vec2 pmax, Vec2 uvmin, Vec2 uvmax) const override;
+
+protected:
+  void updateMatrix() override;
+
+private:
+  struct Command;
+  struct Rasterizer;
+
+  // screen space helpers, all of them record into the current layer
+  void addFill(Vec2 const* pts, sint numpt, uint32_t color) const;
+  void addStroke(Vec2 const* pts, sint numpt, bool closed, float width, uint32_t color) const;
+  void addShape(Vec2 const* pts, sint numpt, bool closed, ShapeStyle const& style) const;
+  void addText(Vec2 pos, StringView text, TextStyle const& style, float scale) const;
+  void execute(Command const& cmd);
+
+  int             width_;
+  int             height_;
+  Vector<uint8_t> pixels_;
+
+  // recorded primitives, executed at `endFrame()`
+  mutable Vector<Command> commands_[static_cast<int>(Layer::Count)];
+  mutable Vector<Vec2>    points_;   // screen space polygons, shared by all commands
+  mutable Vector<sint>    polygons_; // point count of each polygon
+  mutable Vector<Vec2>    scratch_;
+  std::unique_ptr<Rasterizer> rasterizer_;
+};
+// }}} Raster Canvas
+
+} // namespace nged
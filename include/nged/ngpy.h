@@ -9,6 +9,7 @@
 #include "nlohmann/json.hpp"
 #include <pybind11/pybind11.h>
 
+#include <functional>
 #include <map>
 #include <stdexcept>
 
@@ -29,6 +30,36 @@ struct PyPtrEqual
   }
 };
 
+// Batched (De)Serialization {{{
+// python side of `serialize()`
+struct PySerialized
+{
+  bool        ok         = true;  // false if python failed or returned None
+  bool        overridden = false; // python implemented `serialize()` at all
+  std::string data;
+};
+
+// whole-document (de)serialization of PyNodeGraphDoc calls into python with the GIL held once
+// for all items, instead of once per item; see `PyNodeGraphDoc::serializeGraph()`
+// takes the state prefetched for `obj`, false if there is none
+bool pyTakeSerialized(nged::Graph const* graph, void const* obj, PySerialized& state);
+// queues `call` till the document is deserialized, false if no document is being deserialized
+bool pyDeferCall(nged::Graph const* graph, std::function<bool()> call);
+
+// calls `call(item)` now, or with the rest of the batch if there is one
+template<class Item, class F>
+bool pyCallOrDefer(nged::Graph const* graph, Item* item, F call)
+{
+  auto weak = item->weak_from_this();
+  if (!weak.expired() && pyDeferCall(graph, [weak, call]() {
+        auto ptr = weak.lock();
+        return !ptr || call(static_cast<Item*>(ptr.get()));
+      }))
+    return true;
+  return call(item);
+}
+// }}}
+
 // PyGraphItem {{{
 template<class GraphItemBase = nged::GraphItem>
 class PyGraphItemBase : public GraphItemBase
@@ -60,6 +91,13 @@ public:
   bool canMove() const override { PYBIND11_OVERLOAD(bool, nged::GraphItem, canMove, ); }
 
   bool moveTo(nged::Vec2 point) override
+  {
+    auto moved = pyMoveTo(point);
+    this->syncHotFields(); // python may move or resize without calling the base
+    return moved;
+  }
+
+  bool pyMoveTo(nged::Vec2 point)
   {
     PYBIND11_OVERLOAD(bool, nged::GraphItem, moveTo, point);
   }
@@ -68,33 +106,52 @@ public:
   {
     if (!GraphItemBase::serialize(json))
       return false;
+    PySerialized state;
+    if (!pyTakeSerialized(this->parent(), this, state))
+      state = pySerialize();
+    if (state.overridden && state.ok)
+      json["pydata"] = std::move(state.data);
+    return state.ok;
+  }
+
+  virtual bool deserialize(nged::Json const& json) override
+  {
+    if (!GraphItemBase::deserialize(json))
+      return false;
+    return pyCallOrDefer(this->parent(), this, [pystr = json.value("pydata", "")](auto* self) {
+      return self->pyDeserialize(pystr);
+    });
+  }
+
+  // python parts of (de)serialization, they take the GIL themselves
+  PySerialized pySerialize() const
+  {
+    PySerialized state;
     try {
       pybind11::gil_scoped_acquire gil;
       auto pyserialize = pybind11::get_override(this, "serialize");
       if (pyserialize) {
+        state.overridden = true;
         auto pystr = pyserialize();
         if (pystr.is_none())
-          return false;
-        json["pydata"] = pystr.template cast<std::string>();
+          state.ok = false;
+        else
+          state.data = pystr.template cast<std::string>();
       }
-      return true;
     } catch (std::exception const& e) {
       nged::MessageHub::errorf("failed to serialize item: {}", e.what());
-      return false;
+      state.ok = false;
     }
+    return state;
   }
 
-  virtual bool deserialize(nged::Json const& json) override
+  bool pyDeserialize(std::string const& pystr)
   {
-    if (!GraphItemBase::deserialize(json))
-      return false;
     try {
       pybind11::gil_scoped_acquire gil;
       auto pydeserialize = pybind11::get_override(this, "deserialize");
-      if (pydeserialize) {
-        auto pystr = json.value("pydata", "");
+      if (pydeserialize)
         pydeserialize(pystr);
-      }
       return true;
     } catch (std::exception const& e) {
       nged::MessageHub::errorf("failed to deserialize item: {}", e.what());
@@ -263,6 +320,8 @@ public:
   bool deserialize(nged::Json const& json) override;
   void settled() override;
   size_t getExtraDependencies(nged::Vector<nged::ItemID>& deps) override;
+
+  bool pySettled();
 };
 // }}} PyNode
 
@@ -343,6 +402,9 @@ public:
 
   bool serialize(nged::Json& json) const override;
   bool deserialize(nged::Json const& json) override;
+
+  PySerialized pySerialize() const;
+  bool         pyDeserialize(std::string const& pystr);
 };
 // }}}
 
@@ -351,6 +413,12 @@ class PyNodeGraphDoc : public nged::NodeGraphDoc
 {
   bool duringDestruction_ = false;
 
+  // see `serializeGraph()` / `deserializeGraph()`
+  nged::HashMap<void const*, PySerialized> pySerialized_;
+  nged::Vector<std::function<bool()>>      pyDeferredCalls_;
+  bool                                     pyDeferring_ = false;
+  bool                                     pyBatching_  = true;
+
 public:
   using nged::NodeGraphDoc::NodeGraphDoc;
   pybind11::object pyRootGraph;
@@ -402,6 +470,21 @@ public:
     nged::NodeGraphDoc::removeItem(id);
   }
 
+  /// prefetches the python side of every item and graph with the GIL held once, then serializes
+  virtual bool serializeGraph(nged::Graph const* graph, nged::Json& json) override;
+  /// defers python calls of items until the whole graph is deserialized, then makes them with
+  /// the GIL held once, in the order they were requested;
+  /// so python `deserialize()` of an item runs after links are created and after the hot fields
+  /// and search keys of all items are synced, it sees the complete graph
+  virtual bool deserializeGraph(nged::Graph* graph, nged::Json const& json) override;
+
+  /// batching can be turned off to compare against the per-item path
+  void setPyBatching(bool batching) { pyBatching_ = batching; }
+  bool pyBatching() const { return pyBatching_; }
+
+  bool takePySerialized(void const* obj, PySerialized& state);
+  bool deferPyCall(std::function<bool()> call);
+
   virtual ~PyNodeGraphDoc()
   {
     duringDestruction_ = true;
@@ -460,6 +543,28 @@ public:
     pyOnItemHoveredCallback, pyOnSelectionChangedCallback, pyBeforeLinkSetCallback,
     pyOnLinkSetCallback, pyOnLinkRemovedCallback, pyAfterPasteCallback;
 
+  // hooks are resolved when they are set, unset hooks never touch the GIL
+  enum class Hook : int
+  {
+    OnInspect, BeforeItemAdded, AfterItemAdded, BeforeItemRemoved, BeforeNodeRenamed,
+    AfterNodeRenamed, BeforeViewUpdate, AfterViewUpdate, BeforeViewDraw, AfterViewDraw,
+    OnItemClicked, OnItemDoubleClicked, OnItemHovered, OnSelectionChanged, BeforeLinkSet,
+    OnLinkSet, OnLinkRemoved, AfterPaste,
+    Count
+  };
+  struct HookStats
+  {
+    uint64_t calls   = 0;
+    double   seconds = 0; // including time spent waiting for the GIL
+  };
+  static char const*  hookName(Hook hook); // name of the python method, e.g. "beforeViewUpdate"
+  pybind11::function& hookCallback(Hook hook);
+  /// binds the methods `responder` implements as hooks and clears all others,
+  /// attributes are looked up here once, not per call
+  void             setPyResponder(pybind11::object responder);
+  HookStats const& hookStats(Hook hook) const { return hookStats_[static_cast<int>(hook)]; }
+  void             resetHookStats();
+
   void onInspect(nged::InspectorView* view, nged::GraphItem** items, size_t count) override;
   bool beforeItemAdded(nged::Graph* graph, nged::GraphItem* item, nged::GraphItem** replacement)
     override;
@@ -481,6 +586,10 @@ public:
   void onLinkSet(nged::Link* link) override;
   void onLinkRemoved(nged::Link* link) override;
   void afterPaste(nged::Graph* graph, nged::GraphItem** items, size_t count) override;
+
+private:
+  struct HookTimer;
+  HookStats hookStats_[static_cast<int>(Hook::Count)];
 };
 // }}}
 
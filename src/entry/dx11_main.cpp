@@ -33,6 +33,7 @@ void CleanupRenderTarget();
 LRESULT WINAPI WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam);
 
 static nged::App* theApp = nullptr;
+static DWORD      g_mainThreadId = 0;
 
 // Main code
 int startMainLoop()
@@ -119,6 +120,8 @@ int startMainLoop()
     ImVec4 clear_color = ImVec4(0.45f, 0.55f, 0.60f, 1.00f);
 
     theApp->init();
+    g_mainThreadId = ::GetCurrentThreadId();
+    detail::setRedrawWaker([] { ::PostThreadMessage(g_mainThreadId, WM_NULL, 0, 0); });
 
     // Main loop
     bool done = false;
@@ -129,9 +132,11 @@ int startMainLoop()
         // - When io.WantCaptureMouse is true, do not dispatch mouse input data to your main application.
         // - When io.WantCaptureKeyboard is true, do not dispatch keyboard input data to your main application.
         // Generally you may always pass all inputs to dear imgui, and hide them from your application based on those two flags.
+        if (onDemandRedraw() && !detail::hasPendingRedraw())
+            ::MsgWaitForMultipleObjectsEx(0, NULL, DWORD(detail::idleWaitTimeout * 1000), QS_ALLINPUT, MWMO_INPUTAVAILABLE);
         MSG msg;
         ZeroMemory(&msg, sizeof(msg));
-        if (::PeekMessage(&msg, NULL, 0U, 0U, PM_REMOVE))
+        while (::PeekMessage(&msg, NULL, 0U, 0U, PM_REMOVE))
         {
             ::TranslateMessage(&msg);
             ::DispatchMessage(&msg);
@@ -140,6 +145,8 @@ int startMainLoop()
         }
         if (done)
             break;
+        if (!detail::shouldRenderFrame())
+            continue;
 
         // Handle window resize (we don't resize directly in the WM_SIZE handler)
         if (g_ResizeWidth != 0 && g_ResizeHeight != 0)
@@ -174,6 +181,7 @@ int startMainLoop()
         //g_pSwapChain->Present(0, 0); // Present without vsync
     }
 
+    detail::setRedrawWaker(nullptr);
     theApp->quit();
 
     // Cleanup
@@ -259,6 +267,7 @@ LRESULT WINAPI WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
             return 0;
         g_ResizeWidth = (UINT)LOWORD(lParam); // Queue resize
         g_ResizeHeight = (UINT)HIWORD(lParam);
+        requestRedraw(2);
         return 0;
     case WM_SYSCOMMAND:
         if ((wParam & 0xfff0) == SC_KEYMENU) // Disable ALT application menu
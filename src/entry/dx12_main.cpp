@@ -28,6 +28,7 @@ extern IMGUI_IMPL_API LRESULT ImGui_ImplWin32_WndProcHandler(HWND hWnd, UINT msg
 namespace nged {
 
 static nged::App* theApp = nullptr;
+static DWORD      g_mainThreadId = 0;
 
 struct FrameContext
 {
@@ -145,6 +146,8 @@ int startMainLoop()
 
     initializeTextureResourcePool(g_pd3dDevice, g_pd3dSrvDescHeap);
     theApp->init();
+    g_mainThreadId = ::GetCurrentThreadId();
+    detail::setRedrawWaker([] { ::PostThreadMessage(g_mainThreadId, WM_NULL, 0, 0); });
 
     // Main loop
     MSG msg;
@@ -156,12 +159,16 @@ int startMainLoop()
         // - When io.WantCaptureMouse is true, do not dispatch mouse input data to your main application.
         // - When io.WantCaptureKeyboard is true, do not dispatch keyboard input data to your main application.
         // Generally you may always pass all inputs to dear imgui, and hide them from your application based on those two flags.
+        if (onDemandRedraw() && !detail::hasPendingRedraw() && !::PeekMessage(&msg, NULL, 0U, 0U, PM_NOREMOVE))
+            ::MsgWaitForMultipleObjectsEx(0, NULL, DWORD(detail::idleWaitTimeout * 1000), QS_ALLINPUT, MWMO_INPUTAVAILABLE);
         if (::PeekMessage(&msg, NULL, 0U, 0U, PM_REMOVE))
         {
             ::TranslateMessage(&msg);
             ::DispatchMessage(&msg);
             continue;
         }
+        if (!detail::shouldRenderFrame())
+            continue;
 
         // Start the Dear ImGui frame
         ImGui_ImplDX12_NewFrame();
@@ -213,6 +220,7 @@ int startMainLoop()
         frameCtxt->FenceValue = fenceValue;
     }
 
+    detail::setRedrawWaker(nullptr);
     theApp->quit();
 
     WaitForLastSubmittedFrame();
@@ -469,6 +477,7 @@ LRESULT WINAPI WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
             ResizeSwapChain(hWnd, (UINT)LOWORD(lParam), (UINT)HIWORD(lParam));
             CreateRenderTarget();
             ImGui_ImplDX12_CreateDeviceObjects();
+            requestRedraw(2);
         }
         return 0;
     case WM_SYSCOMMAND:
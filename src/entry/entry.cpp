@@ -1,5 +1,8 @@
 #include "entry.h"
 #include "imgui.h"
+#include "imgui_internal.h"
+
+#include <atomic>
 #ifdef _WIN32
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
@@ -43,6 +46,69 @@ void App::init()
   colors[ImGuiCol_NavHighlight]       = ImVec4(0.78f, 0.78f, 0.78f, 1.00f);
 }
 
+// Redraw {{{
+static std::atomic<bool> onDemandRedraw_ = {false};
+static std::atomic<int>  pendingRedrawFrames_ = {1};
+static std::atomic<void (*)()> redrawWaker_ = {nullptr};
+
+// frames to render after an input event, some widgets need a few frames to settle
+static constexpr int inputSettleFrames = 3;
+
+void setOnDemandRedraw(bool enabled)
+{
+  onDemandRedraw_ = enabled;
+  requestRedraw();
+}
+
+bool onDemandRedraw()
+{
+  return onDemandRedraw_;
+}
+
+void requestRedraw(int frames)
+{
+  int current = pendingRedrawFrames_.load();
+  while (current < frames && !pendingRedrawFrames_.compare_exchange_weak(current, frames))
+    ;
+  if (auto* waker = redrawWaker_.load())
+    waker();
+}
+
+namespace detail {
+
+void setRedrawWaker(void (*waker)())
+{
+  redrawWaker_ = waker;
+}
+
+bool hasPendingRedraw()
+{
+  return pendingRedrawFrames_.load() > 0;
+}
+
+bool shouldRenderFrame()
+{
+  if (!onDemandRedraw_)
+    return true;
+  if (auto* ctx = ImGui::GetCurrentContext()) {
+    bool hasInput = !ctx->InputEventsQueue.empty();
+    for (auto* viewport : ctx->Viewports)
+      hasInput |= viewport->PlatformRequestMove || viewport->PlatformRequestResize ||
+                  viewport->PlatformRequestClose;
+    // text inputs need continuous frames for the blinking cursor
+    hasInput |= ctx->IO.WantTextInput;
+    if (hasInput)
+      requestRedraw(inputSettleFrames);
+  }
+  int frames = pendingRedrawFrames_.load();
+  while (frames > 0 && !pendingRedrawFrames_.compare_exchange_weak(frames, frames - 1))
+    ;
+  return frames > 0;
+}
+
+} // namespace detail
+// }}} Redraw
+
 std::wstring utf8towstring(std::string_view str)
 {
   std::wstring wstr;
@@ -34,6 +34,16 @@ static void glfw_close_callback(GLFWwindow* window)
     glfwSetWindowShouldClose(window, GL_FALSE);
 }
 
+static void glfw_size_callback(GLFWwindow* window, int width, int height)
+{
+  requestRedraw(2);
+}
+
+static void glfw_refresh_callback(GLFWwindow* window)
+{
+  requestRedraw();
+}
+
 int startMainLoop()
 {
     // Setup window
@@ -63,6 +73,8 @@ int startMainLoop()
     if (window == nullptr)
         return 1;
     glfwSetWindowCloseCallback(window, glfw_close_callback);
+    glfwSetWindowSizeCallback(window, glfw_size_callback);
+    glfwSetWindowRefreshCallback(window, glfw_refresh_callback);
     glfwMakeContextCurrent(window);
     glfwSwapInterval(1); // Enable vsync
 
@@ -114,6 +126,7 @@ int startMainLoop()
     ImVec4 clear_color = ImVec4(0.45f, 0.55f, 0.60f, 1.00f);
 
     theApp->init();
+    detail::setRedrawWaker([] { glfwPostEmptyEvent(); });
 
     // Main loop
     while (!glfwWindowShouldClose(window))
@@ -123,7 +136,12 @@ int startMainLoop()
         // - When io.WantCaptureMouse is true, do not dispatch mouse input data to your main application.
         // - When io.WantCaptureKeyboard is true, do not dispatch keyboard input data to your main application.
         // Generally you may always pass all inputs to dear imgui, and hide them from your application based on those two flags.
-        glfwPollEvents();
+        if (onDemandRedraw() && !detail::hasPendingRedraw())
+            glfwWaitEventsTimeout(detail::idleWaitTimeout);
+        else
+            glfwPollEvents();
+        if (!detail::shouldRenderFrame())
+            continue;
 
         // Start the Dear ImGui frame
         ImGui_ImplOpenGL3_NewFrame();
@@ -155,6 +173,7 @@ int startMainLoop()
         glfwSwapBuffers(window);
     }
 
+    detail::setRedrawWaker(nullptr);
     theApp->quit();
 
     // Cleanup
@@ -30,6 +30,16 @@ static void glfw_close_callback(GLFWwindow* window)
     glfwSetWindowShouldClose(window, GLFW_FALSE);
 }
 
+static void glfw_size_callback(GLFWwindow* window, int width, int height)
+{
+  requestRedraw(2);
+}
+
+static void glfw_refresh_callback(GLFWwindow* window)
+{
+  requestRedraw();
+}
+
 int startMainLoop()
 {
     // Setup window
@@ -43,6 +53,8 @@ int startMainLoop()
     if (window == nullptr)
         return 1;
     glfwSetWindowCloseCallback(window, glfw_close_callback);
+    glfwSetWindowSizeCallback(window, glfw_size_callback);
+    glfwSetWindowRefreshCallback(window, glfw_refresh_callback);
 
     id <MTLDevice> device = MTLCreateSystemDefaultDevice();
     id <MTLCommandQueue> commandQueue = [device newCommandQueue];
@@ -92,6 +104,7 @@ int startMainLoop()
     ImVec4 clear_color = ImVec4(0.45f, 0.55f, 0.60f, 1.00f);
 
     theApp->init();
+    detail::setRedrawWaker([] { glfwPostEmptyEvent(); });
 
     // Main loop
     while (!glfwWindowShouldClose(window))
@@ -99,7 +112,12 @@ int startMainLoop()
         @autoreleasepool
         {
             // Poll and handle events (inputs, window resize, etc.)
-            glfwPollEvents();
+            if (onDemandRedraw() && !detail::hasPendingRedraw())
+                glfwWaitEventsTimeout(detail::idleWaitTimeout);
+            else
+                glfwPollEvents();
+            if (!detail::shouldRenderFrame())
+                continue;
 
             int width, height;
             glfwGetFramebufferSize(window, &width, &height);
@@ -147,6 +165,7 @@ int startMainLoop()
         }
     }
 
+    detail::setRedrawWaker(nullptr);
     theApp->quit();
 
     // Cleanup
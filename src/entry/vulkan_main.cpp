@@ -388,6 +388,16 @@ static void glfw_close_callback(GLFWwindow* window)
     glfwSetWindowShouldClose(window, false);
 }
 
+static void glfw_size_callback(GLFWwindow* window, int width, int height)
+{
+  requestRedraw(2);
+}
+
+static void glfw_refresh_callback(GLFWwindow* window)
+{
+  requestRedraw();
+}
+
 int startMainLoop()
 {
     // Setup GLFW window
@@ -413,6 +423,8 @@ int startMainLoop()
     SetupVulkan(extensions);
     
     glfwSetWindowCloseCallback(window, glfw_close_callback);
+    glfwSetWindowSizeCallback(window, glfw_size_callback);
+    glfwSetWindowRefreshCallback(window, glfw_refresh_callback);
 
     // Create Window Surface
     VkSurfaceKHR surface;
@@ -488,6 +500,7 @@ int startMainLoop()
     ImVec4 clear_color = ImVec4(0.45f, 0.55f, 0.60f, 1.00f);
 
     theApp->init();
+    detail::setRedrawWaker([] { glfwPostEmptyEvent(); });
 
     // Main loop
     while (!glfwWindowShouldClose(window))
@@ -497,7 +510,12 @@ int startMainLoop()
         // - When io.WantCaptureMouse is true, do not dispatch mouse input data to your main application.
         // - When io.WantCaptureKeyboard is true, do not dispatch keyboard input data to your main application.
         // Generally you may always pass all inputs to dear imgui, and hide them from your application based on those two flags.
-        glfwPollEvents();
+        if (onDemandRedraw() && !detail::hasPendingRedraw())
+            glfwWaitEventsTimeout(detail::idleWaitTimeout);
+        else
+            glfwPollEvents();
+        if (!detail::shouldRenderFrame())
+            continue;
 
         // Resize swap chain?
         if (g_SwapChainRebuild)
@@ -541,6 +559,7 @@ int startMainLoop()
         releaseDeferredTextures();
     }
 
+    detail::setRedrawWaker(nullptr);
     theApp->quit();
 
     // Cleanup
@@ -6,6 +6,7 @@
 #include <spdlog/spdlog.h>
 #include <miniz.h>
 
+#include <cctype>
 #include <charconv>
 #include <deque>
 #include <filesystem>
@@ -109,6 +110,12 @@ bool GraphItem::deserialize(Json const& json)
   return true;
 }
 
+void GraphItem::syncHotFields() const
+{
+  if (id_ != ID_None && parent_ && parent_->docRoot())
+    parent_->docRoot()->syncItemHotFields(this);
+}
+
 void GraphItem::setUID(UID const& uid)
 {
   sourceUID_ = uid_;
@@ -269,6 +276,7 @@ void Node::resize(float width, float height, float varPinWidth, float varMarginW
     for (auto* link : linksIntoThis)
       link->calculatePath();
   }
+  syncHotFields();
 }
 
 bool Node::serialize(Json& json) const
@@ -328,6 +336,7 @@ TypeSystem::TypeIndex TypeSystem::registerType(StringView name, StringView baseT
     typeBaseType_[strname] = baseindex;
     typeConvertable_[std::make_pair(index, baseindex)] = true;
   }
+  closureDirty_ = true;
   static auto constexpr noColor = Color{0,0,0,0};
   if (hintColor != noColor)
     setColorHint(index, hintColor);
@@ -339,6 +348,7 @@ void TypeSystem::setConvertable(StringView from, StringView to, bool convertable
   auto fromindex = registerType(from);
   auto toindex = registerType(to);
   typeConvertable_[std::make_pair(fromindex, toindex)] = convertable;
+  closureDirty_ = true;
 }
 
 bool TypeSystem::isConvertable(StringView from, StringView to) const
@@ -347,14 +357,43 @@ bool TypeSystem::isConvertable(StringView from, StringView to) const
     return true;
   if (to == "any" || to == "*")
     return true;
-  auto fromindex = typeIndex(from);
-  auto toindex = typeIndex(to);
-  auto itr = typeConvertable_.find(std::make_pair(fromindex, toindex));
-  // TODO: if a -> b and b -> c, find a way to convert a -> c
-  if (itr != typeConvertable_.end())
-    return itr->second;
-  else
-    return false;
+  return isConvertable(typeIndex(from), typeIndex(to));
+}
+
+void TypeSystem::rebuildClosure() const
+{
+  std::lock_guard lock(closureMutex_);
+  if (!closureDirty_.load(std::memory_order_relaxed))
+    return;
+  size_t const n      = types_.size();
+  size_t const stride = (n + 63) / 64;
+  Vector<uint64_t> closure(n * stride, 0);
+  auto set = [&](size_t from, size_t to) { closure[from * stride + (to >> 6)] |= 1ull << (to & 63); };
+  auto get = [&](size_t from, size_t to) { return (closure[from * stride + (to >> 6)] >> (to & 63)) & 1; };
+
+  for (size_t i = 0; i < n; ++i) {
+    set(i, i);
+    if (types_[i] == "any" || types_[i] == "*")
+      for (size_t j = 0; j < n; ++j)
+        set(j, i);
+  }
+  for (auto&& [pair, convertable] : typeConvertable_)
+    if (convertable)
+      set(pair.first, pair.second);
+  // Warshall, one row OR per reachable pair
+  for (size_t k = 0; k < n; ++k)
+    for (size_t i = 0; i < n; ++i)
+      if (i != k && get(i, k))
+        for (size_t w = 0; w < stride; ++w)
+          closure[i * stride + w] |= closure[k * stride + w];
+  // explicit denials win over whatever chain there is
+  for (auto&& [pair, convertable] : typeConvertable_)
+    if (!convertable && pair.first != pair.second)
+      closure[pair.first * stride + (pair.second >> 6)] &= ~(1ull << (pair.second & 63));
+
+  closure_       = std::move(closure);
+  closureStride_ = stride;
+  closureDirty_.store(false, std::memory_order_release);
 }
 
 bool TypeSystem::isType(StringView type) const
@@ -395,8 +434,8 @@ StringView TypeSystem::typeBaseType(TypeIndex index) const
 
 Optional<Color> TypeSystem::colorHint(TypeIndex index) const
 {
-  if (auto itr = typeColorHints_.find(index); itr != typeColorHints_.end() && index != InvalidTypeIndex)
-    return Optional<Color>(itr->second);
+  if (index >= 0 && size_t(index) < typeColorHints_.size())
+    return typeColorHints_[index];
   else
     return Optional<Color>{};
 }
@@ -405,25 +444,42 @@ void TypeSystem::setColorHint(TypeIndex index, Color color)
 {
   if (index == InvalidTypeIndex)
     return;
+  if (size_t(index) >= typeColorHints_.size())
+    typeColorHints_.resize(index + 1);
   typeColorHints_[index] = color;
 }
+
+TypeSystem::PinSignature const*
+TypeSystem::pinSignature(Vector<String> const& inputs, Vector<String> const& outputs)
+{
+  String key;
+  for (auto const& type : inputs)
+    key.append(type).push_back('\0');
+  key.push_back('\1');
+  for (auto const& type : outputs)
+    key.append(type).push_back('\0');
+  if (auto itr = signatureIndex_.find(key); itr != signatureIndex_.end())
+    return itr->second;
+
+  auto& signature = signatures_.emplace_back();
+  for (auto const& type : inputs)
+    signature.inputs.push_back(registerType(type));
+  for (auto const& type : outputs)
+    signature.outputs.push_back(registerType(type));
+  signatureIndex_[std::move(key)] = &signature;
+  return &signature;
+}
 // }}} Type System
 
 // Typed Node {{{
 StringView TypedNode::inputType(sint i) const
 {
-  if (i < 0 || i >= numMaxInputs())
-    return "";
-  else
-    return inputTypes_[i];
+  return TypeSystem::instance().typeName(inputTypeIndex(i));
 }
 
 StringView TypedNode::outputType(sint i) const
 {
-  if (i < 0 || i >= numOutputs())
-    return "";
-  else
-    return outputTypes_[i];
+  return TypeSystem::instance().typeName(outputTypeIndex(i));
 }
 
 Color TypedNode::inputPinColor(sint i) const
@@ -431,7 +487,7 @@ Color TypedNode::inputPinColor(sint i) const
   if (i < 0 || i >= numMaxInputs())
     return Node::color();
   else
-    return TypeSystem::instance().colorHint(inputType(i)).value_or(
+    return TypeSystem::instance().colorHint(inputTypeIndex(i)).value_or(
       Node::inputPinColor(i));
 }
 
@@ -440,7 +496,7 @@ Color TypedNode::outputPinColor(sint i) const
   if (i < 0 || i >= numOutputs())
     return Node::color();
   else
-    return TypeSystem::instance().colorHint(outputType(i)).value_or(
+    return TypeSystem::instance().colorHint(outputTypeIndex(i)).value_or(
       Node::outputPinColor(i));
 }
 
@@ -448,13 +504,8 @@ bool TypedNode::acceptInput(sint port, Node const* sourceNode, sint sourcePort)
 {
   auto const* typedSource = sourceNode->asTypedNode();
   assert(typedSource);
-  auto const& typeSystem = TypeSystem::instance();
-  auto const  srcType    = typedSource->outputType(sourcePort);
-  auto const  dstType    = inputType(port);
-  if (typeSystem.isConvertable(srcType, dstType))
-    return true;
-  else 
-    return false;
+  return TypeSystem::instance().isConvertable(
+    typedSource->outputTypeIndex(sourcePort), inputTypeIndex(port));
 }
 
 sint TypedNode::getPinForIncomingLink(ItemID sourceItem, sint sourcePin) const
@@ -473,10 +524,9 @@ sint TypedNode::getPinForIncomingLink(ItemID sourceItem, sint sourcePin) const
   auto const* typedSource = sourceNode->asTypedNode();
   assert(typedSource);
   auto const& typeSystem = TypeSystem::instance();
-  auto const  srcType    = typedSource->outputType(sourcePin);
+  auto const  srcType    = typedSource->outputTypeIndex(sourcePin);
   for (sint i = 0, n = numMaxInputs(); i < n; ++i) {
-    auto const dstType = inputType(i);
-    if (typeSystem.isConvertable(srcType, dstType))
+    if (typeSystem.isConvertable(srcType, inputTypeIndex(i)))
       return i;
   }
   return -1;
@@ -503,6 +553,7 @@ void Link::calculatePath()
   for (auto const& pt : path_)
     aabb_.merge(pt);
   aabb_.expand(2.f);
+  syncHotFields();
 }
 
 bool Link::hitTest(Vec2 pt) const
@@ -725,7 +776,7 @@ CommentBox::CommentBox(Graph* parent) : ResizableBox(parent)
   aabb_            = AABB(-s, s);
   color_           = gmath::fromUint32sRGBA(UIStyle::instance().commentColor);
   backgroundColor_ = gmath::fromUint32sRGBA(UIStyle::instance().commentBackground);
-  text_            = "// some comment";
+  setText("// some comment");
 }
 
 AABB CommentBox::localBound() const
@@ -746,8 +797,21 @@ AABB CommentBox::localBound() const
 
 void CommentBox::setText(String text)
 {
-  // TODO: re-calc aabb
   text_ = std::move(text);
+  // the exact size needs a canvas to measure, which `draw()` does; until then take an upper
+  // bound (one em per byte), so that bounds culling never drops a comment that has grown
+  size_t lines = 1, column = 0, maxColumn = 0;
+  for (char c : text_) {
+    if (c == '\n') {
+      ++lines;
+      column = 0;
+    } else {
+      maxColumn = std::max(maxColumn, ++column);
+    }
+  }
+  auto const em = Canvas::floatFontSize(Canvas::defaultTextStyle.size);
+  textSize_     = Vec2(maxColumn * em, lines * em * 1.5f);
+  syncHotFields();
 }
 
 bool CommentBox::serialize(Json& json) const
@@ -895,6 +959,44 @@ GraphItemPtr Graph::tryGet(ItemID id) const
   return docRoot()->getItem(id);
 }
 
+GraphItem* Graph::getRaw(ItemID id) const
+{
+  return docRoot()->getItemRaw(id);
+}
+
+GraphItem* Graph::tryGetRaw(ItemID id) const
+{
+  if (id == ID_None)
+    return nullptr;
+  if (items_.find(id) == items_.end())
+    return nullptr;
+  return docRoot()->getItemRaw(id);
+}
+
+void Graph::itemsInBound(AABB const& region, Vector<GraphItem*>& result) const
+{
+  auto const& hot = docRoot()->pool().hotFields();
+  for (auto id : items_) {
+    auto const index = id.index();
+#ifdef DEBUG
+    // see `GraphItem::localBound()`, an item changed its bound without syncing it
+    auto const live = hot.item[index]->aabb();
+    assert(hot.bounds[index].min == live.min && hot.bounds[index].max == live.max);
+#endif
+    if (hot.bounds[index].intersects(region))
+      result.push_back(hot.item[index]);
+  }
+}
+
+AABB Graph::itemsBound() const
+{
+  AABB        bb;
+  auto const& hot = docRoot()->pool().hotFields();
+  for (auto id : items_)
+    bb.merge(hot.bounds[id.index()]);
+  return bb;
+}
+
 void Graph::doRemoveNoCheck(ItemID id)
 {
   items_.erase(id);
@@ -1025,6 +1127,27 @@ bool Graph::move(HashSet<ItemID> const& items, Vec2 const& delta)
   return true;
 }
 
+size_t Graph::setPositions(Vector<ItemID> const& items, Vector<Vec2> const& positions)
+{
+  if (readonly()) {
+    msghub::info("graph is read-only, cannot move any item");
+    return 0;
+  }
+  auto            doc     = docRoot();
+  auto            edgroup = doc->editGroup("set positions");
+  HashSet<ItemID> moved;
+  for (size_t i = 0, n = std::min(items.size(), positions.size()); i < n; ++i) {
+    if (auto* item = tryGetRaw(items[i]); item && item->moveTo(positions[i]))
+      moved.insert(items[i]);
+  }
+  if (moved.empty())
+    return 0;
+
+  updateLinkPaths(moved);
+  doc->notifyGraphModified(this);
+  return moved.size();
+}
+
 LinkPtr Graph::getLink(ItemID destItem, sint destPort)
 {
   if (auto itr = linkIDs_.find(OutputConnection{destItem, destPort}); itr != linkIDs_.end())
@@ -1144,6 +1267,94 @@ LinkPtr Graph::setLink(ItemID sourceItem, sint sourcePort, ItemID destItem, sint
   return nullptr;
 }
 
+bool Graph::addBulk(
+  Vector<String> const&   types,
+  Vector<Vec2> const&     positions,
+  Vector<BulkLink> const& links,
+  Vector<ItemID>&         nodeIds,
+  Vector<ItemID>&         linkIds)
+{
+  nodeIds.clear();
+  linkIds.clear();
+  if (readonly()) {
+    msghub::info("graph is read-only, cannot add any item");
+    return false;
+  }
+  auto factory = nodeFactory();
+  if (!factory) {
+    msghub::error("graph has no node factory, cannot add nodes");
+    return false;
+  }
+  auto   doc         = docRoot();
+  auto   edgroup     = doc->editGroup("add bulk");
+  auto   deferNotify = doc->deferModifiedNotify();
+  size_t numFailed   = 0;
+
+  nodeIds.reserve(types.size());
+  for (size_t i = 0, n = types.size(); i < n; ++i) {
+    NodePtr nodeptr;
+    try {
+      nodeptr = factory->createNode(this, types[i]);
+      if (nodeptr && add(nodeptr) == ID_None)
+        nodeptr = nullptr;
+    } catch (std::exception const& e) {
+      msghub::errorf("failed to create node of type \"{}\": {}", types[i], e.what());
+      nodeptr = nullptr;
+    }
+    if (nodeptr) {
+      if (i < positions.size())
+        nodeptr->moveTo(positions[i]);
+      nodeIds.push_back(nodeptr->id());
+    } else {
+      nodeIds.push_back(ID_None);
+      ++numFailed;
+    }
+  }
+
+  // all dest nodes are new, so instead of scanning `links_` for the last variadic input like
+  // `setLink()` does, just count them here, and recalculate their link paths once at the end
+  HashMap<ItemID, sint> nextVarInput;
+  auto                  validIdx = [&nodeIds](sint idx) {
+    return idx >= 0 && size_t(idx) < nodeIds.size() && nodeIds[idx] != ID_None;
+  };
+  linkIds.reserve(links.size());
+  for (auto const& link : links) {
+    auto linkid = ID_None;
+    if (validIdx(link.sourceNode) && validIdx(link.destNode)) {
+      auto srcid    = nodeIds[link.sourceNode];
+      auto dstid    = nodeIds[link.destNode];
+      auto destPort = link.destPort;
+      if (getRaw(dstid)->asNode()->numMaxInputs() < 0) {
+        auto& next = nextVarInput[dstid];
+        if (destPort < 0)
+          destPort = next;
+        next = std::max(next, destPort + 1);
+      }
+      if (destPort >= 0 && checkLinkIsAllowed(srcid, link.sourcePort, dstid, destPort)) {
+        InputConnection  ic = {srcid, link.sourcePort};
+        OutputConnection oc = {dstid, destPort};
+        if (auto existing = linkIDs_.find(oc); existing != linkIDs_.end())
+          doRemoveNoCheck(existing->second);
+        links_[oc] = ic;
+        linkid = linkIDs_[oc] = add(std::make_shared<Link>(this, ic, oc));
+      }
+    }
+    if (linkid == ID_None)
+      ++numFailed;
+    linkIds.push_back(linkid);
+  }
+  if (!nextVarInput.empty()) {
+    for (auto const& [oc, linkid] : linkIDs_)
+      if (nextVarInput.find(oc.destItem) != nextVarInput.end())
+        if (auto* link = getRaw(linkid)->asLink())
+          link->calculatePath();
+  }
+
+  if (numFailed > 0)
+    msghub::warnf("{} of {} nodes and links failed to add", numFailed, types.size() + links.size());
+  return numFailed < types.size() + links.size();
+}
+
 void Graph::removeLink(ItemID destNodeID, sint destPort)
 {
   if (readonly()) {
@@ -1228,7 +1439,7 @@ Vec2 Graph::pinPos(NodePin pin) const
   Vec2 pos     = {0, 0};
   bool located = false;
   assert(items_.find(pin.node) != items_.end());
-  auto itemptr = docRoot()->getItem(pin.node);
+  auto* itemptr = docRoot()->getItemRaw(pin.node);
   if (auto* node = itemptr->asNode()) {
     if (pin.type == NodePin::Type::In) {
       pos     = node->inputPinPos(pin.index);
@@ -1251,7 +1462,7 @@ Vec2 Graph::pinDir(NodePin pin) const
   Vec2 dir     = {1, 0};
   bool located = false;
   assert(items_.find(pin.node) != items_.end());
-  auto itemptr = docRoot()->getItem(pin.node);
+  auto* itemptr = docRoot()->getItemRaw(pin.node);
   if (auto* node = itemptr->asNode()) {
     if (pin.type == NodePin::Type::In) {
       dir     = node->inputPinDir(pin.index);
@@ -1270,7 +1481,7 @@ Color Graph::pinColor(NodePin pin) const
 {
   Color color;
   bool  located = false;
-  auto  itemptr = docRoot()->getItem(pin.node);
+  auto* itemptr = docRoot()->getItemRaw(pin.node);
   if (auto* node = itemptr->asNode()) {
     if (pin.type == NodePin::Type::In) {
       color   = node->inputPinColor(pin.index);
@@ -1440,10 +1651,13 @@ bool Graph::deserialize(Json const& json)
   for (auto&& itemdata : json["items"]) {
     auto uid = itemdata.contains("uid") ? uidFromString(String(itemdata["uid"])) : UID();
     if (auto itr = uidmap.find(uid); itr != uidmap.end()) {
-      if (!get(itr->second)->deserialize(itemdata)) {
+      auto item = get(itr->second);
+      if (!item->deserialize(itemdata)) {
         msghub::errorf("failed to import item {}", itemdata.dump(2));
         return false;
       }
+      doc->syncItemHotFields(item.get());
+      doc->updateSearchKey(item.get());
     } else {
       String       factory = itemdata["f"];
       GraphItemPtr newitem;
@@ -1602,6 +1816,7 @@ bool Graph::traverse(
   auto& outputs  = result.outputs_;
   auto& closures = result.closures_;
   auto& idmap    = result.idmap_;
+  auto& ids      = result.ids_;
   using Range    = GraphTraverseResult::Range;
 
   nodes.clear();
@@ -1609,14 +1824,14 @@ bool Graph::traverse(
   outputs.clear();
   closures.clear();
 
-  HashMap<NodePtr, size_t> nodeIndex; // nodeptr -> index in result.nodes_
-  HashSet<ItemID>          visited;
-  std::deque<ItemID>       toVisit;
+  HashMap<Node const*, size_t> nodeIndex; // node -> index in result.nodes_
+  HashSet<ItemID>              visited;
+  std::deque<ItemID>           toVisit;
 
-  auto indexofnode = [&nodeIndex](GraphItemPtr item) -> size_t {
+  auto indexofnode = [&nodeIndex](GraphItem const* item) -> size_t {
     if (!item || !item->asNode())
       return -1;
-    if (auto itr = nodeIndex.find(std::static_pointer_cast<Node>(item)); itr != nodeIndex.end())
+    if (auto itr = nodeIndex.find(item->asNode()); itr != nodeIndex.end())
       return itr->second;
     else
       return -1;
@@ -1633,13 +1848,13 @@ bool Graph::traverse(
     }
     Vector<ItemID> deps;
     for (auto id : graph->items_) {
-      auto itemptr = graph->get(id);
+      auto* itemptr = graph->getRaw(id);
       if (auto* nodeptr = itemptr->asNode()) {
         if (nodeptr->getExtraDependencies(deps)) {
           for (auto depid : deps) {
             linkDown.emplace(depid, id);
             linkUp.emplace(id, depid);
-            auto depitem = graph->docRoot_->getItem(depid);
+            auto* depitem = graph->docRoot_->getItemRaw(depid);
             referencedGraphs.insert(depitem->parent());
           }
         }
@@ -1664,17 +1879,15 @@ bool Graph::traverse(
 
   HashSet<ItemID> visitedWithNoLoop;
   while (!toVisit.empty()) {
-    auto    id      = toVisit.front();
-    auto    itemptr = get(id);
-    NodePtr nodeptr = nullptr;
+    auto  id      = toVisit.front();
+    auto* itemptr = getRaw(id);
     toVisit.pop_front();
 
     if (!itemptr) {
       msghub::warnf("item {:x} is not a valid target now", id.value());
       continue;
     }
-    if (itemptr->asNode())
-      nodeptr = std::static_pointer_cast<Node>(itemptr);
+    Node* nodeptr = itemptr->asNode();
 
     if (auto itr = visited.find(id); itr != visited.end()) {
       if (!allowLoop) {
@@ -1686,7 +1899,7 @@ bool Graph::traverse(
           String name;
           loopPath.push_back(loopPath.front());
           for (auto id : loopPath) {
-            auto item = docRoot_->getItem(id);
+            auto* item = docRoot_->getItemRaw(id);
             if (auto* node = item->asNode())
               name = node->name();
             else if (item->asRouter())
@@ -1702,9 +1915,9 @@ bool Graph::traverse(
       // move to the back
       if (nodeptr) {
         if (auto itr = nodeIndex.find(nodeptr); itr != nodeIndex.end()) {
-          nodes.push_back(nodeptr);
-          nodes[itr->second] = nullptr;
-          itr->second        = nodes.size() - 1;
+          NodePtr moved = std::move(nodes[itr->second]); // leaves nullptr, compacted below
+          nodes.push_back(std::move(moved));
+          itr->second = nodes.size() - 1;
         } else {
           msghub::error("visited node should have a index");
           assert(false);
@@ -1712,7 +1925,8 @@ bool Graph::traverse(
       }
     } else {
       if (nodeptr) {
-        nodes.push_back(nodeptr);
+        // the only refcounted access, result keeps nodes alive
+        nodes.push_back(std::static_pointer_cast<Node>(nodeptr->shared_from_this()));
         nodeIndex[nodeptr] = nodes.size() - 1;
       }
     }
@@ -1737,8 +1951,8 @@ bool Graph::traverse(
       break;
     if (r == w)
       continue;
-    nodes[w]            = nodes[r];
-    nodeIndex[nodes[w]] = w;
+    nodes[w]                  = std::move(nodes[r]);
+    nodeIndex[nodes[w].get()] = w;
   }
   nodes.resize(denseSize);
 
@@ -1751,13 +1965,12 @@ bool Graph::traverse(
     auto* graph       = nodes[i]->parent();
     if (Vector<ItemID> links; graph->linksOnNode(id, links)) {
       for (auto linkid : links) {
-        if (auto link = graph->get(linkid)->asLink()) {
+        if (auto* link = graph->getRaw(linkid)->asLink()) {
           if (link->output().destItem == id) { // I am the dest
-            NodePtr inNode    = nullptr;
-            auto    inputItem = graph->get(link->input().sourceItem);
+            auto* inputItem = graph->getRaw(link->input().sourceItem);
             while (!inputItem->asNode()) {
               if (InputConnection ic; graph->getLinkSource(inputItem->id(), 0, ic)) {
-                inputItem = graph->get(ic.sourceItem);
+                inputItem = graph->getRaw(ic.sourceItem);
               } else {
                 break;
               }
@@ -1776,7 +1989,7 @@ bool Graph::traverse(
               idsToResolve.pop_back();
               for (auto range = linkDown.equal_range(iid); range.first != range.second;
                    ++range.first) {
-                auto item = graph->get(range.first->second);
+                auto* item = graph->getRaw(range.first->second);
                 if (item->asNode()) {
                   auto idx = indexofnode(item);
                   if (idx == -1)
@@ -1797,8 +2010,11 @@ bool Graph::traverse(
   }
 
   idmap.clear();
-  for (size_t i = 0, n = nodes.size(); i < n; ++i)
-    idmap[nodes[i]->id()] = i;
+  ids.resize(nodes.size());
+  for (size_t i = 0, n = nodes.size(); i < n; ++i) {
+    ids[i] = nodes[i]->id();
+    idmap[ids[i]] = i;
+  }
   return true;
 }
 
@@ -1855,9 +2071,58 @@ ItemID GraphItemPool::add(GraphItemPtr item)
     throw std::runtime_error("got duplicated uid");
   }
   uidMap_[item->uid()] = iid;
+  resetHotFields(iid, item.get());
   return iid;
 }
 
+void GraphItemPool::resetHotFields(ItemID id, GraphItem const* item)
+{
+  auto const index = id.index();
+  if (index >= hot_.size()) {
+    auto const size = items_.size();
+    hot_.id.resize(size, ID_None);
+    hot_.item.resize(size, nullptr);
+    hot_.parent.resize(size, nullptr);
+    hot_.pos.resize(size, Vec2{0, 0});
+    hot_.bounds.resize(size, AABB{});
+    hot_.kind.resize(size, ItemKind::None);
+  }
+  if (!item) {
+    hot_.id[index]     = ID_None;
+    hot_.item[index]   = nullptr;
+    hot_.parent[index] = nullptr;
+    hot_.kind[index]   = ItemKind::None;
+    return;
+  }
+  auto* mutableItem = const_cast<GraphItem*>(item);
+  auto  kind        = ItemKind::Other;
+  if (item->asNode())
+    kind = ItemKind::Node;
+  else if (item->asLink())
+    kind = ItemKind::Link;
+  else if (item->asRouter())
+    kind = ItemKind::Router;
+  else if (mutableItem->asGroupBox())
+    kind = ItemKind::GroupBox;
+  else if (mutableItem->asResizable())
+    kind = ItemKind::Resizable;
+  hot_.id[index]     = id;
+  hot_.item[index]   = mutableItem;
+  hot_.parent[index] = item->parent();
+  hot_.kind[index]   = kind;
+  hot_.pos[index]    = item->pos();
+  hot_.bounds[index] = item->aabb();
+}
+
+void GraphItemPool::syncHotFields(GraphItem const* item)
+{
+  auto const index = item->id().index();
+  if (index >= hot_.size() || hot_.item[index] != item)
+    return; // not (yet) managed by this pool
+  hot_.pos[index]    = item->pos();
+  hot_.bounds[index] = item->aabb();
+}
+
 void GraphItemPool::moveUID(UID const& oldUID, UID const& newUID)
 {
   if (oldUID == newUID)
@@ -1872,6 +2137,156 @@ void GraphItemPool::moveUID(UID const& oldUID, UID const& newUID)
 }
 // }}} GraphItemPool
 
+// Search Index {{{
+static uint32_t packTrigram(char a, char b, char c)
+{
+  return uint32_t(uint8_t(std::tolower(a))) << 16 | uint32_t(uint8_t(std::tolower(b))) << 8 |
+         uint32_t(uint8_t(std::tolower(c)));
+}
+
+template<class F>
+static void forEachTrigram(StringView str, F&& func)
+{
+  for (size_t i = 0; i + 3 <= str.size(); ++i)
+    func(packTrigram(str[i], str[i + 1], str[i + 2]));
+}
+
+static bool containsNoCase(StringView str, StringView pattern)
+{
+  return std::search(
+           str.begin(), str.end(), pattern.begin(), pattern.end(), [](char a, char b) {
+             return std::tolower(uint8_t(a)) == std::tolower(uint8_t(b));
+           }) != str.end();
+}
+
+String NodeSearchIndex::keyOf(Node const* node)
+{
+  StringView key = node->label();
+  if (key.empty())
+    key = node->name();
+  if (key.empty())
+    key = node->type();
+  return String(key);
+}
+
+uint64_t NodeSearchIndex::charMask(StringView str)
+{
+  uint64_t mask = 0;
+  for (auto c : str) {
+    auto lc = std::tolower(uint8_t(c));
+    if (lc >= 'a' && lc <= 'z')
+      mask |= 1ull << (lc - 'a');
+    else if (lc >= '0' && lc <= '9')
+      mask |= 1ull << (26 + lc - '0');
+    else
+      mask |= 1ull << (36 + lc % 28);
+  }
+  return mask;
+}
+
+void NodeSearchIndex::unindex(Entry const& entry)
+{
+  forEachTrigram(entry.key, [this, &entry](uint32_t trigram) {
+    if (auto itr = trigrams_.find(trigram); itr != trigrams_.end()) {
+      itr->second.erase(entry.id);
+      if (itr->second.empty())
+        trigrams_.erase(itr);
+    }
+  });
+}
+
+bool NodeSearchIndex::accepts(Entry const& entry, StringView pattern, uint64_t chars, bool subsequence)
+{
+  return (entry.chars & chars) == chars && (subsequence || containsNoCase(entry.key, pattern));
+}
+
+void NodeSearchIndex::update(ItemID id, Node const* node)
+{
+  auto key = keyOf(node);
+  auto itr = slots_.find(id);
+  if (itr == slots_.end()) {
+    itr = slots_.insert({id, entries_.size()}).first;
+    entries_.push_back({id, {}, 0});
+  }
+  auto& entry = entries_[itr->second];
+  if (entry.chars != 0 && entry.key == key)
+    return;
+  snapshot_.reset();
+  unindex(entry);
+  entry.key   = std::move(key);
+  entry.chars = charMask(entry.key) | 1; // never 0, to tell new entries apart
+  forEachTrigram(entry.key, [this, id](uint32_t trigram) { trigrams_[trigram].insert(id); });
+}
+
+void NodeSearchIndex::remove(ItemID id)
+{
+  auto itr = slots_.find(id);
+  if (itr == slots_.end())
+    return;
+  snapshot_.reset();
+  auto slot = itr->second;
+  slots_.erase(itr);
+  unindex(entries_[slot]);
+  if (slot + 1 != entries_.size()) {
+    entries_[slot]            = std::move(entries_.back());
+    slots_[entries_[slot].id] = slot;
+  }
+  entries_.pop_back();
+}
+
+void NodeSearchIndex::clear()
+{
+  snapshot_.reset();
+  entries_.clear();
+  slots_.clear();
+  trigrams_.clear();
+}
+
+NodeSearchIndex::Snapshot NodeSearchIndex::snapshot() const
+{
+  if (!snapshot_)
+    snapshot_ = std::make_shared<Vector<Entry> const>(entries_);
+  return snapshot_;
+}
+
+bool NodeSearchIndex::narrow(StringView pattern, bool subsequence, Vector<uint32_t>& slots) const
+{
+  if (subsequence || pattern.size() < 3)
+    return false;
+  // every trigram of the pattern must be there, start from the rarest one
+  HashSet<ItemID> const* rarest  = nullptr;
+  bool                   missing = false;
+  forEachTrigram(pattern, [&](uint32_t trigram) {
+    auto itr = trigrams_.find(trigram);
+    if (itr == trigrams_.end())
+      missing = true;
+    else if (!rarest || itr->second.size() < rarest->size())
+      rarest = &itr->second;
+  });
+  if (missing || !rarest)
+    return true;
+  slots.reserve(slots.size() + rarest->size());
+  for (auto id : *rarest)
+    slots.push_back(static_cast<uint32_t>(slots_.at(id)));
+  return true;
+}
+
+void NodeSearchIndex::candidates(StringView pattern, bool subsequence, Vector<Entry>& out) const
+{
+  auto const       chars = charMask(pattern);
+  Vector<uint32_t> slots;
+  if (!narrow(pattern, subsequence, slots)) {
+    for (auto const& entry : entries_)
+      if (accepts(entry, pattern, chars, subsequence))
+        out.push_back(entry);
+    return;
+  }
+  for (auto slot : slots)
+    if (accepts(entries_[slot], pattern, chars, subsequence))
+      out.push_back(entries_[slot]);
+}
+// }}} Search Index
+
 // History {{{
 void NodeGraphDocHistory::reset(bool createInitialCommit)
 {
@@ -1886,20 +2301,32 @@ void NodeGraphDocHistory::reset(bool createInitialCommit)
   doc_->untouch();
 }
 
+// versions are kept as CBOR, which lets items embed binary blobs (`Json::binary`)
+// instead of spelling everything out as JSON text
+struct BinarySerializationScope
+{
+  NodeGraphDoc* doc;
+  bool          old;
+  BinarySerializationScope(NodeGraphDoc* doc) : doc(doc), old(doc->binarySerialization())
+  {
+    doc->setBinarySerialization(true);
+  }
+  ~BinarySerializationScope() { doc->setBinarySerialization(old); }
+};
+
 size_t NodeGraphDocHistory::commit(String msg)
 {
+  if (!doc_)
+    return -1;
   Json json;
-  if (doc_ && doc_->root()->serialize(json)) {
+  BinarySerializationScope binaryScope(doc_);
+  if (doc_->serializeGraph(doc_->root().get(), json)) {
     size_t          versionNumber = versions_.size();
-    String          data          = json.dump();
+    Vector<uint8_t> data          = Json::to_cbor(json);
     auto            size          = data.size();
     Vector<uint8_t> compressedData(mz_compressBound(size));
     mz_ulong        compressedLen = compressedData.size();
-    mz_compress(
-      compressedData.data(),
-      &compressedLen,
-      reinterpret_cast<uint8_t const*>(data.data()),
-      data.size());
+    mz_compress(compressedData.data(), &compressedLen, data.data(), data.size());
     compressedData.resize(compressedLen);
     versions_.push_back({std::move(compressedData), std::move(msg), size});
     assert(versionNumber + 1 == versions_.size());
@@ -1912,6 +2339,8 @@ size_t NodeGraphDocHistory::commit(String msg)
       undoStack_[++indexAtUndoStack_] = versionNumber;
     }
 
+    doc_->refreshSearchKeys(); // whatever was edited may show in labels
+    doc_->refreshHotFields();  // or change bounds
     doc_->touch();
     return versionNumber;
   } else {
@@ -1930,18 +2359,22 @@ bool NodeGraphDocHistory::checkout(size_t version)
     return false;
   }
   ++atEditGroupLevel_; // suspend auto commit from editGroups
-  String   uncompressedData;
-  mz_ulong uncompressedSize = versions_[version].uncompressedSize;
+  Vector<uint8_t> uncompressedData;
+  mz_ulong        uncompressedSize = versions_[version].uncompressedSize;
   uncompressedData.resize(uncompressedSize);
   auto result = mz_uncompress(
-    reinterpret_cast<uint8_t*>(uncompressedData.data()),
+    uncompressedData.data(),
     &uncompressedSize,
     versions_[version].data.data(),
     versions_[version].data.size());
   if (result != MZ_OK)
     throw std::runtime_error("failed to decompress history data");
-  Json json    = Json::parse(uncompressedData);
-  bool succeed = doc_->root()->deserialize(json);
+  Json json = Json::from_cbor(uncompressedData);
+  bool succeed;
+  {
+    BinarySerializationScope binaryScope(doc_);
+    succeed = doc_->deserializeGraph(doc_->root().get(), json);
+  }
   --atEditGroupLevel_;
 
   if (version == fileVersion_) {
@@ -2015,6 +2448,40 @@ NodeGraphDoc::~NodeGraphDoc()
   root_.reset();
 }
 
+ItemID NodeGraphDoc::addItem(GraphItemPtr item)
+{
+  auto* node = item->asNode();
+  auto  id   = pool_.add(std::move(item));
+  if (node)
+    searchIndex_.update(id, node);
+  return id;
+}
+
+void NodeGraphDoc::removeItem(ItemID id)
+{
+  searchIndex_.remove(id);
+  pool_.release(id);
+}
+
+void NodeGraphDoc::updateSearchKey(GraphItem const* item)
+{
+  if (auto* node = item->asNode(); node && pool_.getRaw(item->id()) == item)
+    searchIndex_.update(item->id(), node);
+}
+
+void NodeGraphDoc::refreshSearchKeys()
+{
+  pool_.foreach ([this](auto const& itemptr) {
+    if (auto* node = itemptr->asNode())
+      searchIndex_.update(itemptr->id(), node);
+  });
+}
+
+void NodeGraphDoc::refreshHotFields()
+{
+  pool_.foreach ([this](auto const& itemptr) { pool_.syncHotFields(itemptr.get()); });
+}
+
 void NodeGraphDoc::makeRoot() { root_ = GraphPtr(nodeFactory_->createRootGraph(this)); }
 
 StringView NodeGraphDoc::title() const { return title_; }
@@ -2031,7 +2498,7 @@ try {
   Json injson  = Json::parse(content);
 
   auto newgraph = GraphPtr(nodeFactory_->createRootGraph(this));
-  if (!newgraph->deserialize(injson["root"])) {
+  if (!deserializeGraph(newgraph.get(), injson["root"])) {
     msghub::errorf("failed to deserialize content from {}", path);
     return false;
   }
@@ -2086,7 +2553,7 @@ bool NodeGraphDoc::saveAs(String path)
 bool NodeGraphDoc::saveTo(String path)
 {
   Json outjson;
-  if (!root_->serialize(outjson["root"])) {
+  if (!serializeGraph(root_.get(), outjson["root"])) {
     msghub::error("failed to serialize graph");
     return false;
   }
@@ -2103,34 +2570,149 @@ bool NodeGraphDoc::saveTo(String path)
 
 void NodeGraphDoc::notifyGraphModified(Graph* graph)
 {
-  if (graphModifiedNotifier_)
+  if (deferModifiedLevel_ > 0) {
+    if (std::find(deferredModified_.begin(), deferredModified_.end(), graph) == deferredModified_.end())
+      deferredModified_.push_back(graph);
+  } else if (graphModifiedNotifier_) {
     graphModifiedNotifier_(graph);
+  }
+}
+
+void NodeGraphDoc::flushModifiedNotify()
+{
+  auto graphs = std::move(deferredModified_);
+  deferredModified_.clear();
+  for (auto* graph : graphs)
+    notifyGraphModified(graph);
 }
 // }}} NodeGraphDoc
 
 // MessageHub {{{
 MessageHub MessageHub::instance_;
 
+MessageHub::Ring::Ring() : slots_(new Slot[capacity])
+{
+  for (size_t i = 0; i < capacity; ++i)
+    slots_[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+bool MessageHub::Ring::push(String& content, Verbosity verbosity, TimePoint time)
+{
+  Slot*  slot = nullptr;
+  size_t pos  = tail_.load(std::memory_order_relaxed);
+  for (;;) {
+    slot     = &slots_[pos & (capacity - 1)];
+    auto seq = slot->sequence.load(std::memory_order_acquire);
+    auto dif = static_cast<sint>(seq) - static_cast<sint>(pos);
+    if (dif == 0) {
+      if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+        break;
+    } else if (dif < 0) {
+      return false; // full
+    } else {
+      pos = tail_.load(std::memory_order_relaxed);
+    }
+  }
+  slot->content   = std::move(content);
+  slot->verbosity = verbosity;
+  slot->timestamp = time;
+  slot->sequence.store(pos + 1, std::memory_order_release);
+  return true;
+}
+
+bool MessageHub::Ring::pop(std::deque<Message>& into)
+{
+  size_t pos  = head_.load(std::memory_order_relaxed);
+  auto&  slot = slots_[pos & (capacity - 1)];
+  if (slot.sequence.load(std::memory_order_acquire) != pos + 1)
+    return false;
+  into.emplace_back(std::move(slot.content), slot.verbosity, slot.timestamp);
+  slot.content = String();
+  head_.store(pos + 1, std::memory_order_relaxed);
+  slot.sequence.store(pos + capacity, std::memory_order_release);
+  return true;
+}
+
+bool MessageHub::Ring::empty() const
+{
+  size_t pos = head_.load(std::memory_order_relaxed);
+  return slots_[pos & (capacity - 1)].sequence.load(std::memory_order_acquire) != pos + 1;
+}
+
 void MessageHub::addMessage(
   String                message,
   MessageHub::Category  category,
   MessageHub::Verbosity verbosity)
 {
-  std::unique_lock lock(mutex_);
-  auto             time  = std::chrono::system_clock::now();
-  auto&            queue = messageCategories_[static_cast<int>(category)];
-  if (category == Category::Log)
-    spdlog::log(static_cast<spdlog::level::level_enum>(verbosity), message);
+  if (!accepts(category, verbosity))
+    return;
+  auto  time = std::chrono::system_clock::now();
+  auto& ring = rings_[static_cast<int>(category)];
+  while (!ring.push(message, verbosity, time)) {
+    // nobody has been reading for a while, make room without waiting for them
+    drain(static_cast<int>(category));
+  }
+  if (auto* notify = notifier_.load(std::memory_order_relaxed))
+    notify();
+}
 
-  if (queue.size() > countLimit_)
+void MessageHub::drain(int category) const
+{
+  std::lock_guard lock(drainMutex_);
+  auto&           queue = overflow_[category];
+  while (rings_[category].pop(queue))
+    ;
+  for (size_t limit = countLimit_.load(std::memory_order_relaxed); queue.size() > limit;) {
     queue.pop_front();
-  queue.emplace_back(std::move(message), verbosity, time);
+    ++overflowEvicted_[category];
+  }
+  hasOverflow_.store(true, std::memory_order_release);
+}
+
+void MessageHub::collect() const
+{
+  bool pending = hasOverflow_.load(std::memory_order_acquire);
+  for (auto const& ring : rings_)
+    pending = pending || !ring.empty();
+  if (!pending)
+    return;
+
+  std::unique_lock lock(mutex_);
+  auto&            logs     = messageCategories_[static_cast<int>(Category::Log)];
+  size_t const     firstLog = logs.size();
+  {
+    std::lock_guard drainLock(drainMutex_);
+    hasOverflow_.store(false, std::memory_order_relaxed);
+    for (int i = 0; i < static_cast<int>(Category::Count); ++i) {
+      auto& queue = messageCategories_[i];
+      if (!overflow_[i].empty()) {
+        std::move(overflow_[i].begin(), overflow_[i].end(), std::back_inserter(queue));
+        overflow_[i].clear();
+      }
+      evicted_[i] += overflowEvicted_[i];
+      overflowEvicted_[i] = 0;
+      while (rings_[i].pop(queue))
+        ;
+    }
+  }
+  // sinks are written here instead of on the producer threads, which only ever touch the rings
+  for (size_t i = firstLog; i < logs.size(); ++i)
+    spdlog::log(static_cast<spdlog::level::level_enum>(logs[i].verbosity), logs[i].content);
+  for (int i = 0; i < static_cast<int>(Category::Count); ++i) {
+    auto& queue = messageCategories_[i];
+    while (queue.size() > countLimit_) {
+      queue.pop_front();
+      ++evicted_[i];
+    }
+  }
 }
 
 void MessageHub::clear(Category category)
 {
+  collect();
   std::unique_lock lock(mutex_);
   auto&            queue = messageCategories_[static_cast<int>(category)];
+  evicted_[static_cast<int>(category)] += queue.size();
   queue.clear();
 }
 
@@ -2142,11 +2724,14 @@ void MessageHub::clearAll()
 
 void MessageHub::setCountLimit(size_t count)
 {
+  collect();
   std::unique_lock lock(mutex_);
   countLimit_ = count;
   for (int i = 0; i < static_cast<int>(Category::Count); ++i)
-    while (messageCategories_[i].size() > count)
+    while (messageCategories_[i].size() > count) {
       messageCategories_[i].pop_front();
+      ++evicted_[i];
+    }
 }
 // }}} MessageHub
 
@@ -2189,6 +2774,43 @@ float Canvas::floatFontSize(Canvas::FontSize enumsize)
   }
   return size;
 }
+
+void Canvas::drawRects(
+  AABB const*       rects,
+  sint              count,
+  float             cornerradius,
+  ShapeStyle const* styles,
+  sint              numStyles) const
+{
+  assert(numStyles == 1 || numStyles == count);
+  for (sint i = 0; i < count; ++i)
+    drawRect(rects[i].min, rects[i].max, cornerradius, styles[numStyles == 1 ? 0 : i]);
+}
+
+void Canvas::drawCircles(
+  Vec2 const*       centers,
+  sint              count,
+  float             radius,
+  int               nsegments,
+  ShapeStyle const* styles,
+  sint              numStyles) const
+{
+  assert(numStyles == 1 || numStyles == count);
+  for (sint i = 0; i < count; ++i)
+    drawCircle(centers[i], radius, nsegments, styles[numStyles == 1 ? 0 : i]);
+}
+
+void Canvas::drawPolylines(
+  Vec2 const*       pts,
+  PolyRange const*  polys,
+  sint              npoly,
+  ShapeStyle const* styles,
+  sint              numStyles) const
+{
+  assert(numStyles == 1 || numStyles == npoly);
+  for (sint i = 0; i < npoly; ++i)
+    drawPoly(pts + polys[i].offset, polys[i].count, polys[i].closed, styles[numStyles == 1 ? 0 : i]);
+}
 // }}} Canvas
 
 } // namespace nged
@@ -6,6 +6,21 @@
 
 namespace nged {
 
+// per-thread scratch buffers used to batch primitives without allocating every frame
+struct DrawScratch
+{
+  Vector<Vec2>               points;
+  Vector<Canvas::ShapeStyle> styles;
+
+  static DrawScratch& get()
+  {
+    static thread_local DrawScratch scratch;
+    scratch.points.clear();
+    scratch.styles.clear();
+    return scratch;
+  }
+};
+
 // Node {{{
 void Node::draw(Canvas* canvas, GraphItemState state) const
 {
@@ -70,6 +85,7 @@ void Node::draw(Canvas* canvas, GraphItemState state) const
     }
 
     // pins
+    auto& pins = DrawScratch::get();
     if (numMaxInputs() > 0) {
       for (sint i = 0; i < numMaxInputs(); ++i) {
         auto pinstyle = style;
@@ -83,7 +99,8 @@ void Node::draw(Canvas* canvas, GraphItemState state) const
         } else {
           pinstyle.fillColor = gmath::toUint32RGBA(inputPinColor(i));
         }
-        canvas->drawCircle(inputPinPos(i), UIStyle::instance().nodePinRadius, 0, pinstyle);
+        pins.points.push_back(inputPinPos(i));
+        pins.styles.push_back(pinstyle);
       }
     } else if (numMaxInputs() < 0) {
       if (AABB bb; mergedInputBound(bb))
@@ -94,9 +111,18 @@ void Node::draw(Canvas* canvas, GraphItemState state) const
       auto pinstyle = style;
       for (sint i = 0; i < numOutputs(); ++i) {
         pinstyle.fillColor = gmath::toUint32RGBA(outputPinColor(i));
-        canvas->drawCircle(outputPinPos(i), UIStyle::instance().nodePinRadius, 0, pinstyle);
+        pins.points.push_back(outputPinPos(i));
+        pins.styles.push_back(pinstyle);
       }
     }
+    if (!pins.points.empty())
+      canvas->drawCircles(
+        pins.points.data(),
+        pins.points.size(),
+        UIStyle::instance().nodePinRadius,
+        0,
+        pins.styles.data(),
+        pins.styles.size());
 
     // label
     auto label = this->label();
@@ -148,13 +174,15 @@ void Link::draw(Canvas* canvas, GraphItemState state) const
       style.strokeColor = gmath::toUint32RGBA(dye->color());
     }
   }
+  const Canvas::ShapeStyle hlstyle = {
+    false, 0, UIStyle::instance().linkSelectedWidth, UIStyle::instance().linkSelectedColor};
+  // the selection highlight goes beneath, both strokes share the same path
+  sint const               npt      = path_.size();
+  Canvas::PolyRange const  polys[]  = {{0, npt, false}, {0, npt, false}};
+  Canvas::ShapeStyle const styles[] = {hlstyle, style};
+  sint const               first    = state == GraphItemState::SELECTED ? 0 : 1;
   canvas->pushLayer(Canvas::Layer::Low);
-  if (state == GraphItemState::SELECTED) {
-    const Canvas::ShapeStyle hlstyle = {
-      false, 0, UIStyle::instance().linkSelectedWidth, UIStyle::instance().linkSelectedColor};
-    canvas->drawPoly(path_.data(), path_.size(), false, hlstyle);
-  }
-  canvas->drawPoly(path_.data(), path_.size(), false, style);
+  canvas->drawPolylines(path_.data(), polys + first, 2 - first, styles + first, 2 - first);
   canvas->popLayer();
 }
 // }}} Link
@@ -239,8 +267,12 @@ void CommentBox::draw(Canvas* canvas, GraphItemState state) const
     bgstyle.strokeColor = 0xffffffff;
   }
 
-  textSize_ = canvas->measureTextSize(text_, Canvas::defaultTextStyle);
-  auto box  = aabb();
+  if (auto textSize = canvas->measureTextSize(text_, Canvas::defaultTextStyle);
+      textSize != textSize_) {
+    textSize_ = textSize;
+    syncHotFields(); // bounds grow with text
+  }
+  auto box = aabb();
 
   canvas->pushLayer(Canvas::Layer::Low);
   canvas->drawRect(box.min, box.max, 0, bgstyle);
@@ -271,14 +303,20 @@ void Arrow::draw(Canvas* canvas, GraphItemState state) const
 
   Vec2 tip[] = {rleft.transformPoint(d), end(), rright.transformPoint(d)};
 
-  canvas->pushLayer(Canvas::Layer::Low);
+  // points: [highlight line, highlight tip,] line, tip
+  Vec2                    pts[10];
+  Canvas::PolyRange const polys[] = {{0, 2, false}, {2, 3, false}, {5, 2, false}, {7, 3, false}};
+  Canvas::ShapeStyle      styles[4];
+  sint                    first = 2;
   if (state == GraphItemState::SELECTED) {
     auto const hlstyle = Canvas::ShapeStyle{
       false, 0,
       thickness_*2, UIStyle::instance().arrowSelectedColor};
     line[1] += normalize(d)*thickness_/2;
-    canvas->drawPoly(line, 2, false, hlstyle);
-    canvas->drawPoly(tip, 3, false, hlstyle);
+    std::copy(std::begin(line), std::end(line), pts);
+    std::copy(std::begin(tip), std::end(tip), pts+2);
+    styles[0] = styles[1] = hlstyle;
+    first = 0;
   }
   auto const style = Canvas::ShapeStyle{
     false, 0,
@@ -288,8 +326,11 @@ void Arrow::draw(Canvas* canvas, GraphItemState state) const
     tip[0] += normalize(tip[1]-tip[0])*thickness_/2;
     tip[2] += normalize(tip[1]-tip[2])*thickness_/2;
   }
-  canvas->drawPoly(line, 2, false, style);
-  canvas->drawPoly(tip, 3, false, style);
+  std::copy(std::begin(line), std::end(line), pts+5);
+  std::copy(std::begin(tip), std::end(tip), pts+7);
+  styles[2] = styles[3] = style;
+  canvas->pushLayer(Canvas::Layer::Low);
+  canvas->drawPolylines(pts, polys + first, 4 - first, styles + first, 4 - first);
   canvas->popLayer();
 }
 // }}} Arrow
@@ -1,6 +1,7 @@
 #include <nged/nged.h>
 #include <nged/utils.h>
 #include <nged/style.h>
+#include <nged/entry/entry.h>
 #include "boxer/boxer.h"
 #include "nfd.h"
 
@@ -147,6 +148,7 @@ void AnimationState::tick(NetworkView* view, float dt)
 
   view->canvas()->setViewPos(pos);
   view->canvas()->setViewScale(scale);
+  requestRedraw(); // keep frames coming until the animation settles
 
   if (finished) {
     t_              = 0;
@@ -195,7 +197,7 @@ Node* NetworkView::solySelectedNode() const
 {
   Node* solyNode = nullptr;
   for (auto id: selectedItems_) {
-    if (auto* node = graph()->get(id)->asNode()) {
+    if (auto* node = graph()->getRaw(id)->asNode()) {
       if (solyNode) {
         solyNode = nullptr;
         break;
@@ -232,6 +234,7 @@ int NetworkView::zCompare(GraphItem* lhs, GraphItem* rhs) const
 
 void NetworkView::update(float dt)
 {
+  auto const start = std::chrono::steady_clock::now();
   hiddenOnceItems_.clear();
   // GraphView::update(dt); don't use default logic
   for (auto state : states_) {
@@ -263,16 +266,30 @@ void NetworkView::update(float dt)
       state->active_ = false;
     }
   }
+  frameTime_.update =
+    std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
 }
 
 void NetworkView::updateAndDrawEffects(float dt)
 {
-  for (sint i=sint(effects_.size())-1; i>=0; --i) {
-    if (!effects_[i]->alive())
-      effects_.erase(effects_.begin()+i);
-    else
-      effects_[i]->updateAndDraw(canvas(), dt);
-  }
+  effects_.erase(
+    std::remove_if(
+      effects_.begin(), effects_.end(), [](auto const& effect) { return !effect->alive(); }),
+    effects_.end());
+  effectBatch_.clear();
+  for (auto&& effect : effects_)
+    effect->updateAndDraw(canvas(), dt, effectBatch_);
+  if (!effectBatch_.boxes.empty())
+    canvas()->drawRects(
+      effectBatch_.boxes.data(),
+      sint(effectBatch_.boxes.size()),
+      EffectBatch::boxRadius,
+      effectBatch_.boxStyles.data(),
+      sint(effectBatch_.boxStyles.size()));
+  for (auto const& text : effectBatch_.texts)
+    canvas()->drawText(text.pos, text.text, text.style);
+  if (!effects_.empty())
+    requestRedraw();
 }
 
 void NetworkView::zoomToSelected(float time, bool doScale, int order, Vec2 offset)
@@ -286,10 +303,10 @@ void NetworkView::zoomToSelected(float time, bool doScale, int order, Vec2 offse
     if (graphptr->items().empty())
       bb.merge(Vec2{0, 0});
     else
-      graphptr->forEachItem([&bb](GraphItemPtr item) { bb.merge(item->aabb()); });
+      bb = graphptr->itemsBound();
   } else {
     for (auto id : selectedItems_) {
-      bb.merge(graphptr->get(id)->aabb());
+      bb.merge(graphptr->getRaw(id)->aabb());
     }
   }
   bb.expand(42);
@@ -311,11 +328,10 @@ void NetworkView::zoomToSelected(float time, bool doScale, int order, Vec2 offse
 
 void NetworkView::draw()
 {
+  auto const start = std::chrono::steady_clock::now();
   auto vp       = canvas()->viewport().expanded(50);
-  auto drawItem = [this, &vp](GraphItem* item) {
+  auto drawItem = [this](GraphItem* item) {
     auto state = GraphItemState::DEFAULT;
-    if (!vp.intersects(item->aabb()))
-      return;
     if (hiddenItems_.find(item->id()) != hiddenItems_.end())
       return;
     if (hiddenOnceItems_.find(item->id()) != hiddenOnceItems_.end())
@@ -327,12 +343,8 @@ void NetworkView::draw()
     item->draw(canvas(), state);
   };
   // TODO: move ordered items into class member
-  Vector<GraphItem*> orderedItems(graph()->items().size());
-  std::transform(
-    graph()->items().begin(),
-    graph()->items().end(),
-    orderedItems.begin(),
-    [this, graph = graph()](ItemID id) { return graph->get(id).get(); });
+  Vector<GraphItem*> orderedItems;
+  graph()->itemsInBound(vp, orderedItems); // culled with cached bounds
   std::stable_sort(orderedItems.begin(), orderedItems.end(), [this](auto lhs, auto rhs) {
     return zCompare(lhs, rhs) < 0;
   });
@@ -367,6 +379,8 @@ void NetworkView::draw()
     canvas()->drawTextUntransformed(pos, text, style, dpiScale() * 1.3f);
     canvas()->popLayer();
   }
+  frameTime_.draw =
+    std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
 }
 
 void NetworkView::onDocModified()
@@ -381,19 +395,19 @@ void NetworkView::onGraphModified()
 {
   HashSet<ItemID> validSelection;
   for (auto id : selectedItems_) {
-    if (graph()->tryGet(id))
+    if (graph()->tryGetRaw(id))
       validSelection.insert(id);
   }
   selectedItems_.swap(validSelection);
   validSelection.clear();
   for (auto id : hiddenItems_) {
-    if (graph()->tryGet(id))
+    if (graph()->tryGetRaw(id))
       validSelection.insert(id);
   }
   hiddenItems_.swap(validSelection);
-  if (!graph()->tryGet(hoveringItem_))
+  if (!graph()->tryGetRaw(hoveringItem_))
     hoveringItem_ = ID_None;
-  if (!graph()->tryGet(hoveringPin_.node))
+  if (!graph()->tryGetRaw(hoveringPin_.node))
     hoveringPin_ = PIN_None;
   for (auto state : states_) {
     if (state->active())
@@ -429,7 +443,7 @@ bool NetworkView::toggleNodeFlagOfSelection(uint64_t flag)
     return false;
   }
   for (auto&& id: selectedItems_) {
-    if (auto* node = graph->get(id)->asNode()) {
+    if (auto* node = graph->getRaw(id)->asNode()) {
       if ((node->flags() & flag) == 0) {
         flagAllSet = false;
         break;
@@ -438,13 +452,13 @@ bool NetworkView::toggleNodeFlagOfSelection(uint64_t flag)
   }
   if (flagAllSet) {
     for (auto&& id: selectedItems_) {
-      if (auto* node = graph->get(id)->asNode()) {
+      if (auto* node = graph->getRaw(id)->asNode()) {
         node->setFlags(node->flags() & ~flag);
       }
     }
   } else {
     for (auto&& id: selectedItems_) {
-      if (auto* node = graph->get(id)->asNode()) {
+      if (auto* node = graph->getRaw(id)->asNode()) {
         node->setFlags(node->flags() | flag);
       }
     }
@@ -995,7 +1009,7 @@ void InspectorView::removeExpiredItems()
 {
   Vector<ItemID> expired;
   for (auto&& id : inspectingItems_) {
-    if (!graph()->tryGet(id))
+    if (!graph()->tryGetRaw(id))
       expired.push_back(id);
   }
   for (auto id : expired) {
@@ -1220,6 +1234,7 @@ void NodeGraphEditor::initCommands()
             msghub::warnf("cannot rename node to {}", args);
           else {
             msghub::debugf("rename node {} to {}", oldname, newname);
+            view->graph()->docRoot()->updateSearchKey(node);
             view->graph()->docRoot()->history().commitIfAppropriate("rename node");
           }
           return;
@@ -1441,12 +1456,19 @@ void NodeGraphEditor::initCommands()
 }
 // }}} Builtin Commands
 
+NodeGraphEditor::NodeGraphEditor()
+{
+  // messages may come from worker threads while the main loop sleeps in on-demand mode
+  MessageHub::instance().setNotifier([] { requestRedraw(); });
+}
+
 NodeGraphEditor::ViewPtr NodeGraphEditor::addView(NodeGraphEditor::DocPtr doc, String const& kind)
 {
   ViewPtr view = viewFactory_->createView(kind, this, doc);
   if (!view)
     return nullptr;
   pendingAddViews_.insert(view);
+  requestRedraw(2);
   return view;
 }
 
@@ -1591,10 +1613,13 @@ void NodeGraphEditor::update(float dt)
     if (responser_)
       responser_->afterViewUpdate(view.get());
   }
+  // forwards log messages to spdlog even when no message view is open
+  MessageHub::instance().flush();
 }
 
 void NodeGraphEditor::notifyGraphModified(Graph* graph)
 {
+  requestRedraw();
   for (auto&& v : views_) {
     if (v->doc().get() == graph->docRoot())
       v->onDocModified();
@@ -1641,6 +1666,7 @@ void NodeGraphEditor::removeView(ViewPtr view)
   if (responser_ && !responser_->beforeViewRemoved(view.get()))
     return;
   pendingRemoveViews_.insert(view);
+  requestRedraw(2);
   if (views_.size() == pendingRemoveViews_.size())
     this->createNewDocAndDefaultViews(); // keep at least one view
 }
@@ -4,6 +4,7 @@
 #include <nged/style.h>
 #include <nged/utils.h>
 #include <nged/res/fa_icondef.h>
+#include <nged/entry/entry.h>
 #include <nged/entry/texture.h>
 
 #include <nlohmann/json.hpp>
@@ -14,9 +15,13 @@
 #include <misc/cpp/imgui_stdlib.h>
 
 #include <algorithm>
+#include <atomic>
 #include <charconv>
+#include <future>
 #include <limits>
 #include <memory>
+#include <numeric>
+#include <thread>
 
 static constexpr char licenses_json[] =
 #include "res/licenses.inl"
@@ -282,6 +287,45 @@ static Vector<StringView> fuzzy_match_and_sort(
   return result;
 }
 
+/// scores `key(i)` for every `i` in `indices`, returns (score, i) of the matched ones, best
+/// first; long lists are split into chunks that are scored in parallel
+template<class GetKey>
+static Vector<std::pair<int, uint32_t>>
+fuzzy_match_parallel(StringView pattern, Vector<uint32_t> const& indices, GetKey&& key)
+{
+  constexpr size_t chunkSize  = 2048;
+  auto             scoreRange = [&](size_t begin, size_t end) {
+    Vector<std::pair<int, uint32_t>> result;
+    for (size_t i = begin; i < end; ++i)
+      if (int score = 0; fuzzy_match(pattern, key(indices[i]), score))
+        result.emplace_back(score, indices[i]);
+    return result;
+  };
+
+  Vector<std::pair<int, uint32_t>> matches;
+  if (indices.size() <= chunkSize) {
+    matches = scoreRange(0, indices.size());
+  } else {
+    size_t const numChunks = std::min<size_t>(
+      std::max(1u, std::thread::hardware_concurrency()),
+      (indices.size() + chunkSize - 1) / chunkSize);
+    size_t const perChunk = (indices.size() + numChunks - 1) / numChunks;
+    Vector<std::future<Vector<std::pair<int, uint32_t>>>> parts;
+    for (size_t begin = perChunk; begin < indices.size(); begin += perChunk)
+      parts.push_back(std::async(
+        std::launch::async, scoreRange, begin, std::min(begin + perChunk, indices.size())));
+    matches = scoreRange(0, std::min(perChunk, indices.size()));
+    for (auto& part : parts) {
+      auto partMatches = part.get();
+      matches.insert(matches.end(), partMatches.begin(), partMatches.end());
+    }
+  }
+  std::sort(matches.begin(), matches.end(), [](auto const& a, auto const& b) {
+    return a.first > b.first || (a.first == b.first && a.second < b.second);
+  });
+  return matches;
+}
+
 } // namespace helper
 // }}} helper
 
@@ -345,11 +389,46 @@ Canvas::ImagePtr Canvas::createImage(uint8_t const* data, int width, int height)
 
 class ImGuiCanvas : public Canvas
 {
-  ImDrawList* drawList_;
-  Vec2        windowOffset_ = {0, 0};
+  ImDrawList*          drawList_;
+  Vec2                 windowOffset_ = {0, 0};
+  mutable Vector<Vec2> scratch_; // transformed points, reused across draw calls
 
   friend void setupImGuiCanvas(Canvas*, ImDrawList*);
 
+  // transforms points to screen space into the scratch buffer
+  ImVec2 const* transformPoints(Vec2 const* pts, sint numpt) const
+  {
+    scratch_.resize(numpt);
+    canvasToScreen_.transformPoints(pts, scratch_.data(), numpt);
+    return imvec(scratch_.data());
+  }
+  void addRect(ImVec2 pmin, ImVec2 pmax, float cornerradius, ShapeStyle const& style) const
+  {
+    if (style.filled)
+      drawList_->AddRectFilled(pmin, pmax, utils::bswap(style.fillColor), cornerradius);
+    if (style.strokeWidth * viewScale_ > 0.1f)
+      drawList_->AddRect(
+        pmin, pmax, utils::bswap(style.strokeColor), cornerradius, 0, style.strokeWidth * viewScale_);
+  }
+  void addCircle(ImVec2 center, float radius, int nsegments, ShapeStyle const& style) const
+  {
+    if (style.filled)
+      drawList_->AddCircleFilled(center, radius, utils::bswap(style.fillColor), nsegments);
+    if (style.strokeWidth * viewScale_ > 0.1f)
+      drawList_->AddCircle(
+        center, radius, utils::bswap(style.strokeColor), nsegments, style.strokeWidth * viewScale_);
+  }
+  void addPoly(ImVec2 const* pts, int npt, bool closed, ShapeStyle const& style) const
+  {
+    if (closed && style.filled)
+      drawList_->AddConvexPolyFilled(pts, npt, utils::bswap(style.fillColor));
+    if (style.strokeWidth * viewScale_ > 0.1f) {
+      auto flags = closed ? ImDrawFlags_Closed : 0;
+      drawList_->AddPolyline(
+        pts, npt, utils::bswap(style.strokeColor), flags, style.strokeWidth * viewScale_);
+    }
+  }
+
 public:
   ImGuiCanvas() : Canvas(), drawList_(nullptr) {}
 
@@ -382,55 +461,76 @@ public:
   void drawRect(Vec2 topleft, Vec2 bottomright, float cornerradius, ShapeStyle style)
     const override
   {
-    if (style.filled)
-      drawList_->AddRectFilled(
-        imvec(canvasToScreen_.transformPoint(topleft)),
-        imvec(canvasToScreen_.transformPoint(bottomright)),
-        utils::bswap(style.fillColor),
-        cornerradius * viewScale_);
-    if (style.strokeWidth * viewScale_ > 0.1f)
-      drawList_->AddRect(
-        imvec(canvasToScreen_.transformPoint(topleft)),
-        imvec(canvasToScreen_.transformPoint(bottomright)),
-        utils::bswap(style.strokeColor),
-        cornerradius * viewScale_,
-        0,
-        style.strokeWidth * viewScale_);
+    addRect(
+      imvec(canvasToScreen_.transformPoint(topleft)),
+      imvec(canvasToScreen_.transformPoint(bottomright)),
+      cornerradius * viewScale_,
+      style);
   }
   void drawCircle(Vec2 center, float radius, int nsegments, ShapeStyle style) const override
   {
-    center = canvasToScreen_.transformPoint(center);
-    radius = radius * viewScale_;
-    if (style.filled)
-      drawList_->AddCircleFilled(imvec(center), radius, utils::bswap(style.fillColor), nsegments);
-    if (style.strokeWidth * viewScale_ > 0.1f) {
-      drawList_->AddCircle(
-        imvec(center),
-        radius,
-        utils::bswap(style.strokeColor),
-        nsegments,
-        style.strokeWidth * viewScale_);
-    }
+    addCircle(
+      imvec(canvasToScreen_.transformPoint(center)), radius * viewScale_, nsegments, style);
   }
   void drawPoly(Vec2 const* pts, sint numpt, bool closed, ShapeStyle style) const override
   {
     int npt = static_cast<int>(numpt);
     assert(sint(npt) == numpt);
-    Vector<ImVec2> transformed(numpt);
-    for (sint i = 0; i < numpt; ++i) {
-      transformed[i] = imvec(canvasToScreen_.transformPoint(pts[i]));
-    }
-
-    if (closed && style.filled)
-      drawList_->AddConvexPolyFilled(transformed.data(), npt, utils::bswap(style.fillColor));
-    if (style.strokeWidth * viewScale_ > 0.1f) {
-      auto flags = closed ? ImDrawFlags_Closed : 0;
-      drawList_->AddPolyline(
-        transformed.data(),
-        npt,
-        utils::bswap(style.strokeColor),
-        flags,
-        style.strokeWidth * viewScale_);
+    addPoly(transformPoints(pts, numpt), npt, closed, style);
+  }
+  void drawRects(
+    AABB const*       rects,
+    sint              count,
+    float             cornerradius,
+    ShapeStyle const* styles,
+    sint              numStyles) const override
+  {
+    static_assert(sizeof(AABB) == sizeof(Vec2) * 2, "AABB should be tightly packed");
+    assert(numStyles == 1 || numStyles == count);
+    if (count <= 0)
+      return;
+    // AABB is {min, max}, so the rects can be transformed as a flat array of corners
+    auto const* corners = transformPoints(&rects->min, count * 2);
+    for (sint i = 0; i < count; ++i)
+      addRect(
+        corners[i * 2],
+        corners[i * 2 + 1],
+        cornerradius * viewScale_,
+        styles[numStyles == 1 ? 0 : i]);
+  }
+  void drawCircles(
+    Vec2 const*       centers,
+    sint              count,
+    float             radius,
+    int               nsegments,
+    ShapeStyle const* styles,
+    sint              numStyles) const override
+  {
+    assert(numStyles == 1 || numStyles == count);
+    if (count <= 0)
+      return;
+    auto const* transformed = transformPoints(centers, count);
+    for (sint i = 0; i < count; ++i)
+      addCircle(transformed[i], radius * viewScale_, nsegments, styles[numStyles == 1 ? 0 : i]);
+  }
+  void drawPolylines(
+    Vec2 const*       pts,
+    PolyRange const*  polys,
+    sint              npoly,
+    ShapeStyle const* styles,
+    sint              numStyles) const override
+  {
+    assert(numStyles == 1 || numStyles == npoly);
+    if (npoly <= 0)
+      return;
+    sint numpt = 0;
+    for (sint i = 0; i < npoly; ++i)
+      numpt = std::max(numpt, polys[i].offset + polys[i].count);
+    auto const* transformed = transformPoints(pts, numpt);
+    for (sint i = 0; i < npoly; ++i) {
+      int npt = static_cast<int>(polys[i].count);
+      assert(sint(npt) == polys[i].count);
+      addPoly(transformed + polys[i].offset, npt, polys[i].closed, styles[numStyles == 1 ? 0 : i]);
     }
   }
   Vec2 measureTextSize(StringView text, TextStyle const& style) const override
@@ -515,7 +615,10 @@ void ImGuiCommentBox::onInspect(GraphView* inspector)
 {
   ImGui::TextUnformatted("Comment:");
   ImGui::PushItemWidth(-4);
-  if (ImGui::InputTextMultiline("##Comment", &text_, ImVec2(0,0), ImGuiInputTextFlags_EnterReturnsTrue))
+  auto const committed = ImGui::InputTextMultiline("##Comment", &text_, ImVec2(0,0), ImGuiInputTextFlags_EnterReturnsTrue);
+  if (ImGui::IsItemEdited())
+    setText(text_); // keeps the bounds up to date
+  if (committed)
     if (auto graph = parent())
       if (auto doc = graph->docRoot())
         doc->history().commitIfAppropriate("edit commit");
@@ -838,7 +941,88 @@ class FindNodeCommand : public CommandManager::Command
     ItemID id;
     String label;
   };
-  std::multimap<int, MatchingItem, std::greater<>> matchedNodes_;
+  using Matches = std::multimap<int, MatchingItem, std::greater<>>;
+  Matches      matchedNodes_;
+  Vector<AABB> highlights_;
+
+  // the worker gets the search index's shared snapshot, plus the trigram narrowed slots when
+  // there are, and does both the filtering and scoring; a superseded worker sees `cancel_`
+  // set and gives up early
+  std::future<Matches>               pending_;
+  std::shared_ptr<std::atomic<bool>> cancel_;
+
+  static constexpr size_t maxListed_ = 100;
+
+  static Matches score(
+    NodeSearchIndex::Snapshot          entries,
+    Vector<uint32_t>                   slots,
+    bool                               narrowed,
+    String                             pattern,
+    bool                               fuzzy,
+    std::shared_ptr<std::atomic<bool>> cancel)
+  {
+    Matches    result;
+    auto const chars = NodeSearchIndex::charMask(pattern);
+    auto const count = narrowed ? slots.size() : entries->size();
+    for (size_t i = 0; i < count; ++i) {
+      if ((i & 1023) == 0 && cancel->load(std::memory_order_relaxed))
+        return {};
+      auto const& entry = (*entries)[narrowed ? slots[i] : i];
+      if (!NodeSearchIndex::accepts(entry, pattern, chars, fuzzy))
+        continue;
+      if (fuzzy) {
+        if (int score; helper::fuzzy_match(pattern, entry.key, score))
+          result.insert({score, {entry.id, entry.key}});
+      } else if (StringView(entry.key).substr(0, pattern.size()) == pattern) {
+        result.insert({100, {entry.id, entry.key}});
+      }
+    }
+    requestRedraw();
+    return result;
+  }
+
+  void cancelSearch()
+  {
+    if (cancel_)
+      cancel_->store(true);
+    pending_ = {}; // waits for the worker, which stops at its next check
+  }
+
+  void search(NodeGraphDoc const* doc)
+  {
+    cancelSearch();
+    auto const&      index    = doc->searchIndex();
+    Vector<uint32_t> slots;
+    bool             narrowed = index.narrow(prompt_, fuzzy_, slots);
+    cancel_  = std::make_shared<std::atomic<bool>>(false);
+    pending_ = std::async(
+      std::launch::async,
+      &FindNodeCommand::score,
+      index.snapshot(),
+      std::move(slots),
+      narrowed,
+      prompt_,
+      fuzzy_,
+      cancel_);
+  }
+
+  // select and zoom to node `id`, which may be in another graph than `view` shows
+  static void focus(GraphView* view, ItemID id, bool switchGraph)
+  {
+    if (view->kind() != "network")
+      return;
+    auto* netview = static_cast<NetworkView*>(view);
+    auto* item    = view->graph()->docRoot()->getItemRaw(id);
+    if (!item || !item->parent())
+      return;
+    if (item->parent() != view->graph().get()) {
+      if (!switchGraph)
+        return;
+      netview->reset(item->parent()->shared_from_this());
+    }
+    netview->setSelectedItems({id});
+    netview->zoomToSelected(0.2f, true, 1);
+  }
 
 public:
   FindNodeCommand(Shortcut shortcut):
@@ -846,14 +1030,21 @@ public:
   {
     setMayModifyGraph(false);
   }
+  ~FindNodeCommand() { cancelSearch(); }
   void onConfirm(GraphView* view) override
   {
     auto* netview = static_cast<NetworkView*>(view);
     HashSet<ItemID> ids;
     for (auto&& pair: matchedNodes_)
-      ids.insert(pair.second.id);
-    netview->setSelectedItems(ids);
-    netview->zoomToSelected(0.5f);
+      if (view->graph()->tryGet(pair.second.id))
+        ids.insert(pair.second.id);
+    if (ids.empty() && !matchedNodes_.empty()) {
+      // only found in other graphs, go to the best match
+      focus(view, matchedNodes_.begin()->second.id, true);
+    } else {
+      netview->setSelectedItems(ids);
+      netview->zoomToSelected(0.5f);
+    }
     matchedNodes_.clear();
   }
   bool hasPrompt() const override { return true; }
@@ -867,51 +1058,47 @@ public:
     if (!view) return false;
     auto  graph = view->graph();
     if (!graph) return false;
-    auto* netview = static_cast<NetworkView*>(view);
+    auto* doc = graph->docRoot();
     if (recheck) {
       matchedNodes_.clear();
-      for (auto id : graph->items()) {
-        if (auto* node = graph->get(id)->asNode()) {
-          StringView name = node->label();
-          if (name.empty())
-            name = node->name();
-          if (name.empty())
-            name = node->type();
-          if (fuzzy_) {
-            if (int score; helper::fuzzy_match(prompt_, name, score)) {
-              matchedNodes_.insert({score, {id, String(name)}});
-            }
-          } else {
-            if (
-              name.size() >= prompt_.size() &&
-              name.substr(0, prompt_.size()) == prompt_)
-              matchedNodes_.insert({100, {id, String(name)}});
-          }
-        }
-      }
+      search(doc);
+    }
+    if (pending_.valid()) {
+      if (pending_.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+        matchedNodes_ = pending_.get();
+      else
+        ImGui::TextDisabled("searching ...");
     }
     if (!matchedNodes_.empty())
       ImGui::Separator();
+    size_t listed = 0;
     for (auto&& pair: matchedNodes_) {
-      if (auto itemptr = graph->get(pair.second.id)) {
-        if (auto* nodeptr = itemptr->asNode()) {
-          auto label = fmt::format("{}##{}", pair.second.label, pair.second.id.value());
-          bool clicked = ImGui::MenuItem(label.c_str());
-          if (ImGui::IsItemHovered() || clicked) {
-            if (view->kind()=="network") {
-              auto* netview = static_cast<NetworkView*>(view);
-              netview->setSelectedItems({pair.second.id});
-              netview->zoomToSelected(0.2f, true, 1);
-            }
-            if (ImGui::IsKeyPressed(ImGuiKey_Enter))
-              return false;
-          }
-          if (clicked)
-            return false;
+      if (listed == maxListed_) {
+        ImGui::TextDisabled("... and %zu more", matchedNodes_.size() - listed);
+        break;
+      }
+      auto* itemptr = doc->getItemRaw(pair.second.id);
+      if (!itemptr || !itemptr->asNode())
+        continue;
+      ++listed;
+      auto* owner = itemptr->parent();
+      auto  label = owner == graph.get()
+                      ? fmt::format("{}##{}", pair.second.label, pair.second.id.value())
+                      : fmt::format(
+                          "{}  ({})##{}", pair.second.label, owner->name(), pair.second.id.value());
+      bool clicked = ImGui::MenuItem(label.c_str());
+      if (ImGui::IsItemHovered() || clicked) {
+        focus(view, pair.second.id, clicked);
+        if (ImGui::IsKeyPressed(ImGuiKey_Enter)) {
+          focus(view, pair.second.id, true);
+          return false;
         }
       }
+      if (clicked)
+        return false;
     }
     if (ImGui::IsKeyPressed(ImGuiKey_Escape)) {
+      cancelSearch();
       matchedNodes_.clear();
       return false;
     } else if (ImGui::IsKeyPressed(ImGuiKey_Enter)) {
@@ -925,12 +1112,13 @@ public:
     if (!matchedNodes_.empty()) {
       view->canvas()->pushLayer(ImGuiCanvas::Layer::Higher);
       auto const style = Canvas::ShapeStyle{false, 0, 10.f, 0xff0000ff};
+      highlights_.clear();
       for (auto&& pair: matchedNodes_) {
-        if (auto item = view->graph()->tryGet(pair.second.id)) {
-          auto bb = item->aabb().expanded(20.f);
-          view->canvas()->drawRect(bb.min, bb.max, 16.f, style);
-        }
+        if (auto item = view->graph()->tryGet(pair.second.id))
+          highlights_.push_back(item->aabb().expanded(20.f));
       }
+      if (!highlights_.empty())
+        view->canvas()->drawRects(highlights_.data(), highlights_.size(), 16.f, &style);
       view->canvas()->popLayer();
     }
   }
@@ -1130,7 +1318,25 @@ public:
 // Message View {{{
 class ImGuiMessageView: public ImGuiGraphView<ImGuiMessageView, GraphView>
 {
-  String tabToOpen_ = "";
+  // one visible line of a message that passes the filters, messages are split at '\n'
+  // so every clipper item is exactly one text line high
+  struct Line
+  {
+    size_t   serial; // of the message, see `MessageHub::view`
+    uint32_t begin;
+    uint32_t end;
+  };
+  struct LineIndex
+  {
+    size_t           scanned = 0; // serial of the first message not looked at yet
+    std::deque<Line> lines;
+  };
+
+  String          tabToOpen_ = "";
+  LineIndex       index_[static_cast<int>(MessageHub::Category::Count)];
+  ImGuiTextFilter textFilter_;
+  int             verbosityMask_ = (1 << static_cast<int>(MessageHub::Verbosity::Count)) - 1;
+
 public:
   ImGuiMessageView(NodeGraphEditor* editor) :
     ImGuiGraphView(editor, nullptr)
@@ -1148,51 +1354,112 @@ public:
       tabToOpen_ = String(words[1]);
     }
   }
-  void drawContent()
+
+  bool accepts(MessageHub::Message const& msg) const
   {
-    if (ImGui::BeginTabBar("MessageHub")) {
-      auto dumpMessage = [](MessageHub::Category cat){
-        ImGui::PushFont(ImGuiResource::instance().monoFont);
-        ImGui::BeginChild("Content", {0,0}, true);
-        ImGui::PushStyleColor(ImGuiCol_Text, 0xffffffff);
-
-        auto& textColor = ImGui::GetStyle().Colors[ImGuiCol_Text];
-        // log verbosity -> color
-        static const ImVec4 colorMap[] = {
-          {0.5,0.5,0.5,1.0}, // Trace
-          {0.0,0.5,0.1,1.0}, // Debug
-          {1.0,1.0,1.0,1.0}, // Info
-          {1.0,0.5,0.1,1.0}, // Warn
-          {1.0,0.0,0.0,1.0}, // Error
-          {0.6,0.0,0.0,1.0}, // Fatal
-          {1.0,1.0,1.0,1.0}, // Text
-        };
-        static_assert(sizeof(colorMap)/sizeof(*colorMap) == static_cast<int>(MessageHub::Verbosity::Count),
-            "color map missmatch with verbosity count");
-
-        MessageHub::instance().foreach(cat,
-          [&textColor](auto const& msg){
+    return (verbosityMask_ & (1 << static_cast<int>(msg.verbosity))) &&
+           textFilter_.PassFilter(msg.content.c_str(), msg.content.c_str() + msg.content.size());
+  }
+
+  void resetIndex()
+  {
+    for (auto& index : index_)
+      index = LineIndex{};
+  }
+
+  // drops lines of evicted messages, indexes messages added since last frame
+  void updateIndex(LineIndex& index, std::deque<MessageHub::Message> const& messages, size_t first)
+  {
+    while (!index.lines.empty() && index.lines.front().serial < first)
+      index.lines.pop_front();
+    for (size_t serial = std::max(index.scanned, first); serial < first + messages.size(); ++serial) {
+      auto const& content = messages[serial - first].content;
+      if (!accepts(messages[serial - first]))
+        continue;
+      size_t begin = 0;
+      do {
+        size_t end = std::min(content.find('\n', begin), content.size());
+        index.lines.push_back({serial, static_cast<uint32_t>(begin), static_cast<uint32_t>(end)});
+        begin = end + 1;
+      } while (begin < content.size());
+    }
+    index.scanned = first + messages.size();
+  }
+
+  void drawMessages(MessageHub::Category cat)
+  {
+    ImGui::PushFont(ImGuiResource::instance().monoFont);
+    ImGui::BeginChild("Content", {0,0}, true);
+    ImGui::PushStyleColor(ImGuiCol_Text, 0xffffffff);
+
+    auto& textColor = ImGui::GetStyle().Colors[ImGuiCol_Text];
+    // log verbosity -> color
+    static const ImVec4 colorMap[] = {
+      {0.5,0.5,0.5,1.0}, // Trace
+      {0.0,0.5,0.1,1.0}, // Debug
+      {1.0,1.0,1.0,1.0}, // Info
+      {1.0,0.5,0.1,1.0}, // Warn
+      {1.0,0.0,0.0,1.0}, // Error
+      {0.6,0.0,0.0,1.0}, // Fatal
+      {1.0,1.0,1.0,1.0}, // Text
+    };
+    static_assert(sizeof(colorMap)/sizeof(*colorMap) == static_cast<int>(MessageHub::Verbosity::Count),
+        "color map missmatch with verbosity count");
+
+    MessageHub::instance().view(cat,
+      [this, cat, &textColor](auto const& messages, size_t first) {
+        auto& index = index_[static_cast<int>(cat)];
+        updateIndex(index, messages, first);
+        ImGuiListClipper clipper;
+        clipper.Begin(static_cast<int>(index.lines.size()), ImGui::GetTextLineHeightWithSpacing());
+        while (clipper.Step()) {
+          for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i) {
+            auto const& line = index.lines[i];
+            auto const& msg  = messages[line.serial - first];
             textColor = colorMap[static_cast<int>(msg.verbosity)];
-            ImGui::TextUnformatted(msg.content.c_str(), msg.content.c_str()+msg.content.size());
-          });
-        if (ImGui::GetScrollY() >= ImGui::GetScrollMaxY()) {
-          ImGui::SetScrollHereY(1.0f);
+            ImGui::TextUnformatted(msg.content.c_str() + line.begin, msg.content.c_str() + line.end);
+          }
         }
+      });
+    if (ImGui::GetScrollY() >= ImGui::GetScrollMaxY()) {
+      ImGui::SetScrollHereY(1.0f);
+    }
 
-        ImGui::PopStyleColor();
-        ImGui::EndChild();
-        ImGui::PopFont();
-      };
+    ImGui::PopStyleColor();
+    ImGui::EndChild();
+    ImGui::PopFont();
+  }
+
+  void drawFilters()
+  {
+    static const char* verbosityNames[] = {"Trace", "Debug", "Info", "Warn", "Error", "Fatal", "Text"};
+    static_assert(sizeof(verbosityNames)/sizeof(*verbosityNames) == static_cast<int>(MessageHub::Verbosity::Count),
+        "name missmatch with verbosity count");
+    bool changed = false;
+    for (int i = 0; i < static_cast<int>(MessageHub::Verbosity::Count); ++i) {
+      changed |= ImGui::CheckboxFlags(verbosityNames[i], &verbosityMask_, 1 << i);
+      ImGui::SameLine();
+    }
+    changed |= textFilter_.Draw("Filter", -100.f);
+    // only a filter change rescans, new messages are appended to the index incrementally
+    if (changed)
+      resetIndex();
+  }
+
+  void drawContent()
+  {
+    drawFilters();
+    if (ImGui::BeginTabBar("MessageHub")) {
       if (ImGui::BeginTabItem("Log", nullptr, tabToOpen_ == "log" ? ImGuiTabItemFlags_SetSelected : 0)) {
-        dumpMessage(MessageHub::Category::Log);
+        drawMessages(MessageHub::Category::Log);
         ImGui::EndTabItem();
       }
       if (ImGui::BeginTabItem("Notice", nullptr, tabToOpen_ == "notice" ? ImGuiTabItemFlags_SetSelected : 0)) {
-        dumpMessage(MessageHub::Category::Notice);
+        drawMessages(MessageHub::Category::Notice);
         ImGui::EndTabItem();
       }
       if (ImGui::BeginTabItem("Output", nullptr, tabToOpen_ == "output" ? ImGuiTabItemFlags_SetSelected : 0)) {
-        dumpMessage(MessageHub::Category::Output);
+        drawMessages(MessageHub::Category::Output);
         ImGui::EndTabItem();
       }
       tabToOpen_ = "";
@@ -1349,6 +1616,8 @@ void ImGuiNodeGraphEditor::initCommands()
 void ImGuiNodeGraphEditor::draw()
 {
   mainDockID_ = ImGui::DockSpaceOverViewport();
+  if (!runOnceBeforeDraw_.empty())
+    requestRedraw(2); // deferred work may change the layout, let it settle
   for (auto&& f : runOnceBeforeDraw_)
     f();
   runOnceBeforeDraw_.clear();
@@ -1656,14 +1925,16 @@ bool SelectionState::update(NetworkView* view)
     if (isReplacingSelection)
       selectedThisFrame_.clear();
     if ((isBoxSelecting_ || isBoxDeselecting_)) {
-      view->graph()->forEachItem([&](GraphItemPtr item) {
+      Vector<GraphItem*> candidates;
+      view->graph()->itemsInBound(selectionBox, candidates);
+      for (auto* item : candidates) {
         if (item->hitTest(selectionBox)) {
           if (isBoxSelecting_)
             selectedThisFrame_.insert(item->id());
           else // deselecting
             selectedThisFrame_.erase(item->id());
         }
-      });
+      }
       /*
       // when box selecting, don't select links by default
       if (!selectedThisFrame_.empty()) {
@@ -1725,10 +1996,10 @@ void SelectionState::draw(NetworkView* view)
   auto* canvas = view->canvas();
   canvas->pushLayer(Canvas::Layer::High);
   for (auto id : deselectedThisFrame_) {
-    view->graph()->get(id)->draw(canvas, GraphItemState::DESELECTED);
+    view->graph()->getRaw(id)->draw(canvas, GraphItemState::DESELECTED);
   }
   for (auto id : selectedThisFrame_) {
-    view->graph()->get(id)->draw(canvas, GraphItemState::SELECTED);
+    view->graph()->getRaw(id)->draw(canvas, GraphItemState::SELECTED);
   }
   canvas->popLayer();
 
@@ -1762,14 +2033,14 @@ void SelectionState::onGraphModified(NetworkView* view)
 {
   HashSet<ItemID> validSelection;
   for (auto id : confirmedItemSelection_) {
-    if (view->graph()->get(id)) {
+    if (view->graph()->getRaw(id)) {
       validSelection.insert(id);
     }
   }
   confirmedItemSelection_.swap(validSelection);
   validSelection.clear();
   for (auto id : selectedThisFrame_) {
-    if (view->graph()->get(id)) {
+    if (view->graph()->getRaw(id)) {
       validSelection.insert(id);
     }
   }
@@ -1794,53 +2065,52 @@ bool HandleView::update(NetworkView* view)
   GraphItem* hoveringItem = nullptr;
   view->setHoveringItem(ID_None);
   view->setHoveringPin(PIN_None);
-  view->graph()->forEachItem([&mousepos, &hoveringItem, view](GraphItemPtr item) {
-    auto biggerBound = item->aabb().expanded(8.f);
-    if (biggerBound.contains(mousepos)) {
-      if (auto* node = item->asNode()) {
-        if (AABB bb; node->mergedInputBound(bb)) {
-          if (bb.contains(mousepos)) {
-            view->setHoveringPin({item->id(), -1, NodePin::Type::In});
-          }
-        } else {
-          auto ic = node->numMaxInputs();
-          assert(ic >= 0 && ic < 100);
-          for (int i = 0; i < ic; ++i) {
-            if (
-              distance(node->inputPinPos(i), mousepos) < UIStyle::instance().nodePinRadius * 1.5f) {
-              view->setHoveringPin({item->id(), i, NodePin::Type::In});
-              break;
-            }
-          }
+  Vector<GraphItem*> candidates; // items whose bound expanded by 8 contains mouse
+  view->graph()->itemsInBound(AABB(mousepos).expanded(8.f), candidates);
+  for (auto* item : candidates) {
+    if (auto* node = item->asNode()) {
+      if (AABB bb; node->mergedInputBound(bb)) {
+        if (bb.contains(mousepos)) {
+          view->setHoveringPin({item->id(), -1, NodePin::Type::In});
         }
-
-        auto oc = node->numOutputs();
-        for (int i = 0; i < oc; ++i) {
+      } else {
+        auto ic = node->numMaxInputs();
+        assert(ic >= 0 && ic < 100);
+        for (int i = 0; i < ic; ++i) {
           if (
-            distance(node->outputPinPos(i), mousepos) < UIStyle::instance().nodePinRadius * 1.5f) {
-            view->setHoveringPin({item->id(), i, NodePin::Type::Out});
+            distance(node->inputPinPos(i), mousepos) < UIStyle::instance().nodePinRadius * 1.5f) {
+            view->setHoveringPin({item->id(), i, NodePin::Type::In});
             break;
           }
         }
       }
-      if (
-        view->hoveringPin().node == ID_None &&
-        item->hitTest(mousepos) &&
-        (hoveringItem == nullptr || view->zCompare(hoveringItem, item.get()) <= 0)) {
-        hoveringItem = item.get();
-        view->setHoveringItem(item->id());
+
+      auto oc = node->numOutputs();
+      for (int i = 0; i < oc; ++i) {
+        if (
+          distance(node->outputPinPos(i), mousepos) < UIStyle::instance().nodePinRadius * 1.5f) {
+          view->setHoveringPin({item->id(), i, NodePin::Type::Out});
+          break;
+        }
       }
     }
-  });
+    if (
+      view->hoveringPin().node == ID_None &&
+      item->hitTest(mousepos) &&
+      (hoveringItem == nullptr || view->zCompare(hoveringItem, item) <= 0)) {
+      hoveringItem = item;
+      view->setHoveringItem(item->id());
+    }
+  }
   // scan again for routers, routers have higher priority, otherwise they will likely be blocked by
   // links
-  view->graph()->forEachItem([&mousepos, view](GraphItemPtr item) {
+  for (auto* item : candidates) {
     if (auto* router = item->asRouter()) {
       if (router->hitTest(mousepos)) {
         view->setHoveringItem(item->id());
       }
     }
-  });
+  }
 
   if (view->hoveringItem() != ID_None) {
     auto item = view->graph()->get(view->hoveringItem());
@@ -1877,7 +2147,7 @@ bool HandleView::update(NetworkView* view)
 
   if (!panButtonDown_ && buttonDownNow &&
       (view->hoveringItem() == ID_None ||
-       view->graph()->get(view->hoveringItem())->asGroupBox())) {
+       view->graph()->getRaw(view->hoveringItem())->asGroupBox())) {
     mouseAnchor_ = vec(ImGui::GetMousePos());
     viewAnchor_  = canvas->viewPos();
     canPan_      = true;
@@ -1910,7 +2180,7 @@ bool HandleView::update(NetworkView* view)
 void HandleView::draw(NetworkView* view)
 {
   if (auto pin = view->hoveringPin(); pin != PIN_None) {
-    auto* node = view->graph()->get(pin.node)->asNode();
+    auto* node = view->graph()->getRaw(pin.node)->asNode();
     assert(node);
     Vec2               pos   = view->graph()->pinPos(pin);
     Canvas::ShapeStyle style = {true, toUint32RGBA(view->graph()->pinColor(pin)), 0.f, 0x0};
@@ -1959,7 +2229,7 @@ bool MoveState::shouldEnter(NetworkView const* view) const
 {
   if (view->readonly())
     return false;
-  auto hovering = view->graph()->get(view->hoveringItem());
+  auto* hovering = view->graph()->getRaw(view->hoveringItem());
   return view->isFocused() && ImGui::IsMouseClicked(ImGuiMouseButton_Left) &&
          ImGui::GetIO().KeyMods == 0 && hovering &&
          !hovering->asLink() &&
@@ -2497,7 +2767,7 @@ bool CutLinkState::update(NetworkView* view)
     AABB strokeBounds;
     for (auto&& p: stroke_)
       strokeBounds.merge(p);
-    view->graph()->forEachLink([this, &linksToRemove, strokeBounds](LinkPtr link){
+    view->graph()->forEachLinkRaw([this, &linksToRemove, strokeBounds](Link* link){
       if (link->aabb().intersects(strokeBounds)) {
         if (gmath::strokeIntersects(stroke_, link->path()))
           linksToRemove.insert(link->id());
@@ -2613,7 +2883,18 @@ bool CreateNodeState::shouldExit(NetworkView const* view) const
 void CreateNodeState::onEnter(NetworkView* view)
 {
   input_ = "";
-  orderedMatches_.clear();
+  matchedInput_.clear();
+  matches_.clear();
+  candidates_.clear();
+  for (String const& name : view->editor()->itemFactory()->listNames())
+    candidates_.push_back({MatchItem::ITEM, name, name});
+  view->graph()->nodeFactory()->listNodeTypes(
+    view->graph().get(), this, [](void* ctx, StringView cat, StringView type, StringView name) {
+      auto* state = static_cast<CreateNodeState*>(ctx);
+      state->candidates_.push_back({MatchItem::NODE, String(type), String(name)});
+    });
+  for (uint32_t i = 0; i < candidates_.size(); ++i)
+    matches_.emplace_back(0, i); // default order
   confirmedNodeType_ = "";
   confirmedItemType_ = "";
   isConfirmed_       = false;
@@ -2693,70 +2974,66 @@ bool CreateNodeState::update(NetworkView* view)
         ImGui::InputText("##nodeClass", &newInput, ImGuiInputTextFlags_EnterReturnsTrue);
       ImGui::Separator();
 
-      auto itemNames = itemFactory->listNames();
-      if (newInput != input_ || (orderedMatches_.empty())) {
+      if (newInput != input_) {
         input_ = newInput;
-        orderedMatches_.clear();
+        // a longer query can only match what the shorter one did, refine those
+        Vector<uint32_t> indices;
+        if (
+          !matchedInput_.empty() && !input_.empty() && input_.size() > matchedInput_.size() &&
+          StringView(input_).substr(0, matchedInput_.size()) == matchedInput_) {
+          indices.reserve(matches_.size());
+          for (auto const& match : matches_)
+            indices.push_back(match.second);
+        } else {
+          indices.resize(candidates_.size());
+          std::iota(indices.begin(), indices.end(), 0);
+        }
         if (!input_.empty()) {
-          for (String const& name : itemNames) {
-            int score = 0;
-            if (helper::fuzzy_match(input_, name, score)) {
-              orderedMatches_.insert({score, {MatchItem::ITEM, name, name}});
-            }
-          }
-          nodeFactory->listNodeTypes(
-            view->graph().get(), this,
-            [](void* ctx, StringView cat, StringView type, StringView name) {
-              auto* state  = static_cast<CreateNodeState*>(ctx);
-              int   score = 0;
-              if (helper::fuzzy_match(state->input_, name, score)) {
-                state->orderedMatches_.insert({score, {MatchItem::NODE, String(type), String(name)}});
-              }
-            });
+          matches_ = helper::fuzzy_match_parallel(
+            input_, indices, [this](uint32_t i) -> StringView { return candidates_[i].name; });
         } else {
           // default order
-          tempCounter_ = 0;
-          for (String const& name : itemNames) {
-            orderedMatches_.insert({tempCounter_--, {MatchItem::ITEM, name, name}});
-          }
-          nodeFactory->listNodeTypes(
-            view->graph().get(), this,
-            [](void* ctx, StringView cat, StringView type, StringView name) {
-              auto* state = static_cast<CreateNodeState*>(ctx);
-              state->orderedMatches_.insert({state->tempCounter_, {MatchItem::NODE, String(type), String(name)}});
-              --state->tempCounter_;
-            });
+          matches_.clear();
+          for (auto i : indices)
+            matches_.emplace_back(0, i);
         }
+        matchedInput_ = input_;
       }
-      for (auto itr = orderedMatches_.begin(); itr != orderedMatches_.end(); ++itr) {
-        if (itr->second.kind==MatchItem::ITEM)
-          ImGui::PushStyleColor(ImGuiCol_Text, 0xFF4796D3);
-        String menustr = itr->second.name; //fmt::format("{} ({})", itr->second.name, itr->second.type);
-        if (
-          ImGui::MenuItem(menustr.c_str(), nullptr) ||
-          (ImGui::IsItemFocused() && ImGui::IsKeyPressed(ImGuiKey_Enter))) {
-          isConfirmed_ = true;
-          if (itr->second.kind==MatchItem::ITEM) {
-            confirmedItemType_ = itr->second.type;
-            confirmedNodeType_ = input_ = "";
-          } else {
-            confirmedItemType_ = "";
-            confirmedNodeType_ = input_ = itr->second.type;
+      ImGuiListClipper clipper;
+      clipper.Begin(static_cast<int>(matches_.size()));
+      while (clipper.Step()) {
+        for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i) {
+          auto const& match = candidates_[matches_[i].second];
+          if (match.kind==MatchItem::ITEM)
+            ImGui::PushStyleColor(ImGuiCol_Text, 0xFF4796D3);
+          ImGui::PushID(i);
+          if (
+            ImGui::MenuItem(match.name.c_str(), nullptr) ||
+            (ImGui::IsItemFocused() && ImGui::IsKeyPressed(ImGuiKey_Enter))) {
+            isConfirmed_ = true;
+            if (match.kind==MatchItem::ITEM) {
+              confirmedItemType_ = match.type;
+              confirmedNodeType_ = input_ = "";
+            } else {
+              confirmedItemType_ = "";
+              confirmedNodeType_ = input_ = match.type;
+            }
           }
+          ImGui::PopID();
+          if (match.kind==MatchItem::ITEM)
+            ImGui::PopStyleColor();
         }
-        if (itr->second.kind==MatchItem::ITEM)
-          ImGui::PopStyleColor();
       }
       if (isConfirmed_ && confirmedNodeType_ == "" && confirmedItemType_ == "") {
         if (ImGui::GetIO().KeyMods != ImGuiMod_Ctrl) {
-          if (!orderedMatches_.empty()) {
-            auto itr = orderedMatches_.begin();
-            if (itr->second.kind==MatchItem::ITEM) {
-              confirmedItemType_ = itr->second.type;
+          if (!matches_.empty()) {
+            auto const& best = candidates_[matches_.front().second];
+            if (best.kind==MatchItem::ITEM) {
+              confirmedItemType_ = best.type;
               confirmedNodeType_ = input_ = "";
             } else {
               confirmedItemType_ = "";
-              confirmedNodeType_ = input_ = itr->second.type;
+              confirmedNodeType_ = input_ = best.type;
             }
           }
         }
@@ -10,13 +10,11 @@
 namespace nged {
 namespace detail {
 
-void reloadImGuiFonts(ImFont* &sansSerif, ImFont* &mono, ImFont* &icon, ImFont* &large, ImFont* &largeIcon)
+void addDefaultFonts(ImFontAtlas* atlas, ImFont* &sansSerif, ImFont* &mono, ImFont* &icon, ImFont* &large, ImFont* &largeIcon)
 {
-  auto* atlas = ImGui::GetIO().Fonts;
   auto const& style = UIStyle::instance();
   static const ImWchar rangesIcons[] = { ICON_MIN_FA, ICON_MAX_FA, 0 };
 
-  atlas->Clear();
   sansSerif = atlas->AddFontFromMemoryCompressedTTF(roboto_medium_compressed_data, roboto_medium_compressed_size, style.normalFontSize, nullptr, atlas->GetGlyphRangesGreek());
   large = atlas->AddFontFromMemoryCompressedTTF(roboto_medium_compressed_data, roboto_medium_compressed_size, style.bigFontSize*2, nullptr, atlas->GetGlyphRangesGreek());
   mono = atlas->AddFontFromMemoryCompressedTTF(sourcecodepro_compressed_data, sourcecodepro_compressed_size, style.normalFontSize, nullptr, atlas->GetGlyphRangesGreek());
@@ -24,5 +22,12 @@ void reloadImGuiFonts(ImFont* &sansSerif, ImFont* &mono, ImFont* &icon, ImFont*
   largeIcon = atlas->AddFontFromMemoryCompressedTTF(FontAwesomeSolid_compressed_data, FontAwesomeSolid_compressed_size, style.bigFontSize*2, nullptr, rangesIcons);
 }
 
+void reloadImGuiFonts(ImFont* &sansSerif, ImFont* &mono, ImFont* &icon, ImFont* &large, ImFont* &largeIcon)
+{
+  auto* atlas = ImGui::GetIO().Fonts;
+  atlas->Clear();
+  addDefaultFonts(atlas, sansSerif, mono, icon, large, largeIcon);
+}
+
 } // namespace detail
 } // namespace nged
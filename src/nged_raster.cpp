@@ -0,0 +1,684 @@
+#include <nged/nged_raster.h>
+#include <nged/style.h>
+#include <nged/utils.h>
+
+#include <imgui.h>
+#include <miniz.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <fstream>
+
+namespace nged {
+
+using msghub = MessageHub;
+
+namespace detail {
+void addDefaultFonts(
+  ImFontAtlas* atlas,
+  ImFont*&     sansSerif,
+  ImFont*&     mono,
+  ImFont*&     icon,
+  ImFont*&     large,
+  ImFont*&     largeIcon);
+}
+
+// Fonts {{{
+// a standalone font atlas, glyphs are sampled from the CPU side alpha texture,
+// so no ImGui context or GPU texture is needed
+class RasterFonts
+{
+  ImFontAtlas atlas_;
+  ImFont*     sansSerif_ = nullptr;
+  ImFont*     mono_      = nullptr;
+  ImFont*     icon_      = nullptr;
+  ImFont*     large_     = nullptr;
+  ImFont*     largeIcon_ = nullptr;
+
+  RasterFonts()
+  {
+    detail::addDefaultFonts(&atlas_, sansSerif_, mono_, icon_, large_, largeIcon_);
+    atlas_.Build();
+    atlas_.GetTexDataAsAlpha8(&pixels, &width, &height);
+  }
+
+public:
+  unsigned char* pixels = nullptr;
+  int            width  = 0;
+  int            height = 0;
+
+  static RasterFonts const& instance()
+  {
+    static RasterFonts fonts;
+    return fonts;
+  }
+
+  // same rule as ImGuiResource::getBestMatchingFont
+  ImFont* match(Canvas::TextStyle const& style, float scale) const
+  {
+    float const size = Canvas::floatFontSize(style.size) * scale;
+    auto const& ui   = UIStyle::instance();
+    if (style.font == Canvas::FontFamily::Icon)
+      return size >= ui.normalFontSize * 1.4f && largeIcon_ ? largeIcon_ : icon_;
+    else if (style.font == Canvas::FontFamily::Mono)
+      return mono_;
+    else
+      return size >= ui.normalFontSize * 1.4f && large_ ? large_ : sansSerif_;
+  }
+
+  float sample(float x, float y) const // bilinear, in texels
+  {
+    x -= 0.5f;
+    y -= 0.5f;
+    int const   ix = int(std::floor(x)), iy = int(std::floor(y));
+    float const fx = x - ix, fy = y - iy;
+    auto texel = [this](int tx, int ty) -> float {
+      if (tx < 0 || ty < 0 || tx >= width || ty >= height)
+        return 0.f;
+      return pixels[ty * width + tx] / 255.f;
+    };
+    return (texel(ix, iy) * (1 - fx) + texel(ix + 1, iy) * fx) * (1 - fy) +
+           (texel(ix, iy + 1) * (1 - fx) + texel(ix + 1, iy + 1) * fx) * fy;
+  }
+};
+// }}} Fonts
+
+// Pixel Ops {{{
+static inline void blendPixel(uint8_t* dst, uint32_t color, float coverage)
+{
+  float const sa = (color & 0xff) / 255.f * coverage;
+  if (sa <= 0.f)
+    return;
+  float const da = dst[3] / 255.f * (1.f - sa);
+  float const oa = sa + da;
+  for (int c = 0; c < 3; ++c) {
+    float const sc = float((color >> (24 - c * 8)) & 0xff);
+    dst[c]         = uint8_t((sc * sa + dst[c] * da) / oa + 0.5f);
+  }
+  dst[3] = uint8_t(oa * 255.f + 0.5f);
+}
+
+static inline uint32_t scaleAlpha(uint32_t color, float scale)
+{
+  auto const a = uint32_t(std::clamp((color & 0xff) * scale, 0.f, 255.f));
+  return (color & 0xffffff00) | a;
+}
+
+static void circlePath(Vec2 center, float radius, int nsegments, Vector<Vec2>& out)
+{
+  if (nsegments <= 0)
+    nsegments = std::clamp(int(radius * 0.5f) * 4, 12, 64);
+  for (int i = 0; i < nsegments; ++i) {
+    float const a = float(gmath::pi * 2 * i / nsegments);
+    out.push_back(center + Vec2{std::cos(a), std::sin(a)} * radius);
+  }
+}
+
+static void roundRectPath(Vec2 pmin, Vec2 pmax, float radius, Vector<Vec2>& out)
+{
+  if (pmin.x > pmax.x)
+    std::swap(pmin.x, pmax.x);
+  if (pmin.y > pmax.y)
+    std::swap(pmin.y, pmax.y);
+  radius = std::min({radius, (pmax.x - pmin.x) / 2, (pmax.y - pmin.y) / 2});
+  if (radius < 0.5f) {
+    out.insert(out.end(), {pmin, Vec2{pmax.x, pmin.y}, pmax, Vec2{pmin.x, pmax.y}});
+    return;
+  }
+  int const  nseg      = std::clamp(int(radius / 2), 2, 8);
+  Vec2 const centers[] = {
+    {pmax.x - radius, pmin.y + radius},
+    {pmax.x - radius, pmax.y - radius},
+    {pmin.x + radius, pmax.y - radius},
+    {pmin.x + radius, pmin.y + radius}};
+  for (int corner = 0; corner < 4; ++corner) {
+    for (int i = 0; i <= nseg; ++i) {
+      float const a = float(gmath::pi / 2 * (corner - 1 + float(i) / nseg));
+      out.push_back(centers[corner] + Vec2{std::cos(a), std::sin(a)} * radius);
+    }
+  }
+}
+// }}} Pixel Ops
+
+// Rasterizer {{{
+// anti-aliased scanline polygon filler with non-zero winding rule,
+// all polygons added before `fill()` are unioned and blended at once
+struct RasterCanvas::Rasterizer
+{
+  static constexpr int subsamples = 4;
+
+  struct Edge
+  {
+    float x0, y0, y1, dxdy;
+    int   dir;
+  };
+  struct Crossing
+  {
+    float x;
+    int   dir;
+    bool  operator<(Crossing const& that) const { return x < that.x; }
+  };
+  Vector<Edge>     edges;
+  Vector<Edge>     active;
+  Vector<Crossing> crossings;
+  Vector<float>    row;
+  float            minx = FLT_MAX, maxx = -FLT_MAX;
+
+  void reset()
+  {
+    edges.clear();
+    minx = FLT_MAX;
+    maxx = -FLT_MAX;
+  }
+
+  void addPolygon(Vec2 const* pts, sint numpt)
+  {
+    if (numpt < 3)
+      return;
+    // normalize orientation, so that overlapping polygons add up instead of cancelling out
+    float area = 0.f;
+    for (sint i = 0; i < numpt; ++i) {
+      auto const a = pts[i], b = pts[(i + 1) % numpt];
+      area += a.x * b.y - b.x * a.y;
+    }
+    int const orientation = area < 0 ? -1 : 1;
+    for (sint i = 0; i < numpt; ++i) {
+      auto a = pts[i], b = pts[(i + 1) % numpt];
+      minx   = std::min(minx, a.x);
+      maxx   = std::max(maxx, a.x);
+      if (a.y == b.y)
+        continue;
+      int dir = orientation;
+      if (a.y > b.y) {
+        std::swap(a, b);
+        dir = -dir;
+      }
+      edges.push_back({a.x, a.y, b.y, (b.x - a.x) / (b.y - a.y), dir});
+    }
+  }
+
+  void span(float xa, float xb, int x0, int x1, float weight)
+  {
+    xa = std::max(xa, float(x0));
+    xb = std::min(xb, float(x1));
+    if (xa >= xb)
+      return;
+    int const ia = int(xa), ib = int(xb);
+    if (ia == ib) {
+      row[ia - x0] += (xb - xa) * weight;
+      return;
+    }
+    row[ia - x0] += (ia + 1 - xa) * weight;
+    for (int i = ia + 1; i < ib; ++i)
+      row[i - x0] += weight;
+    if (ib < x1)
+      row[ib - x0] += (xb - ib) * weight;
+  }
+
+  void fill(uint8_t* pixels, int width, int height, uint32_t color)
+  {
+    if (edges.empty())
+      return;
+    float miny = FLT_MAX, maxy = -FLT_MAX;
+    for (auto const& e : edges) {
+      miny = std::min(miny, e.y0);
+      maxy = std::max(maxy, e.y1);
+    }
+    int const x0 = std::max(0, int(std::floor(minx)));
+    int const x1 = std::min(width, int(std::ceil(maxx)));
+    int const y0 = std::max(0, int(std::floor(miny)));
+    int const y1 = std::min(height, int(std::ceil(maxy)));
+    if (x0 >= x1 || y0 >= y1)
+      return;
+
+    std::sort(edges.begin(), edges.end(), [](Edge const& a, Edge const& b) { return a.y0 < b.y0; });
+    active.clear();
+    row.resize(x1 - x0);
+    size_t      next   = 0;
+    float const weight = 1.f / subsamples;
+    for (int y = y0; y < y1; ++y) {
+      std::fill(row.begin(), row.end(), 0.f);
+      bool covered = false;
+      for (int s = 0; s < subsamples; ++s) {
+        float const sy = y + (s + 0.5f) * weight;
+        while (next < edges.size() && edges[next].y0 <= sy)
+          active.push_back(edges[next++]);
+        active.erase(
+          std::remove_if(active.begin(), active.end(), [sy](Edge const& e) { return e.y1 <= sy; }),
+          active.end());
+        if (active.empty())
+          continue;
+        crossings.clear();
+        for (auto const& e : active)
+          crossings.push_back({e.x0 + (sy - e.y0) * e.dxdy, e.dir});
+        std::sort(crossings.begin(), crossings.end());
+        int   winding = 0;
+        float start   = 0.f;
+        for (auto const& c : crossings) {
+          int const prev = winding;
+          winding += c.dir;
+          if (prev == 0 && winding != 0) {
+            start = c.x;
+          } else if (prev != 0 && winding == 0) {
+            span(start, c.x, x0, x1, weight);
+            covered = true;
+          }
+        }
+      }
+      if (!covered)
+        continue;
+      uint8_t* line = pixels + (size_t(y) * width + x0) * 4;
+      for (int i = 0, n = x1 - x0; i < n; ++i)
+        if (row[i] > 0.f)
+          blendPixel(line + i * 4, color, std::min(row[i], 1.f));
+    }
+  }
+};
+// }}} Rasterizer
+
+// Raster Canvas {{{
+struct RasterCanvas::Command
+{
+  enum class Kind
+  {
+    Fill,
+    Text,
+    Image
+  };
+  Kind     kind;
+  uint32_t color = 0;
+
+  // Fill: polygons [firstPolygon, firstPolygon+numPolygons) in `polygons_`, starting from
+  // `firstPoint` in `points_`
+  sint firstPolygon = 0, numPolygons = 0, firstPoint = 0;
+
+  // Text
+  String        text;
+  ImFont const* font     = nullptr;
+  float         fontsize = 0.f;
+
+  // Image
+  ImagePtr image;
+  Vec2     pmin, pmax, uvmin, uvmax;
+};
+
+RasterCanvas::RasterCanvas(int width, int height)
+    : Canvas(), width_(0), height_(0), rasterizer_(std::make_unique<Rasterizer>())
+{
+  resize(width, height);
+}
+
+RasterCanvas::~RasterCanvas() = default;
+
+void RasterCanvas::resize(int width, int height)
+{
+  width_  = std::max(width, 1);
+  height_ = std::max(height, 1);
+  pixels_.assign(size_t(width_) * height_ * 4, 0);
+  viewSize_ = Vec2(float(width_), float(height_));
+  updateMatrix();
+}
+
+void RasterCanvas::updateMatrix()
+{
+  canvasToScreen_ = Mat3::fromSRT(Vec2(viewScale_, viewScale_), 0.f, -viewPos_) *
+                    Mat3::fromRTS(Vec2(1, 1), 0, viewSize_ * 0.5f);
+  screenToCanvas_ = canvasToScreen_.inverse();
+}
+
+void RasterCanvas::beginFrame(uint32_t clearColor)
+{
+  for (auto& layer : commands_)
+    layer.clear();
+  points_.clear();
+  polygons_.clear();
+  layerStack_.clear();
+  layer_ = Layer::Standard;
+  for (size_t i = 0, n = pixels_.size(); i < n; i += 4) {
+    pixels_[i + 0] = uint8_t(clearColor >> 24);
+    pixels_[i + 1] = uint8_t(clearColor >> 16);
+    pixels_[i + 2] = uint8_t(clearColor >> 8);
+    pixels_[i + 3] = uint8_t(clearColor);
+  }
+}
+
+void RasterCanvas::endFrame()
+{
+  for (auto& layer : commands_) {
+    for (auto const& cmd : layer)
+      execute(cmd);
+    layer.clear();
+  }
+  points_.clear();
+  polygons_.clear();
+}
+
+void RasterCanvas::execute(Command const& cmd)
+{
+  switch (cmd.kind) {
+  case Command::Kind::Fill: {
+    rasterizer_->reset();
+    for (sint i = 0, pt = cmd.firstPoint; i < cmd.numPolygons; ++i) {
+      sint const n = polygons_[cmd.firstPolygon + i];
+      rasterizer_->addPolygon(points_.data() + pt, n);
+      pt += n;
+    }
+    rasterizer_->fill(pixels_.data(), width_, height_, cmd.color);
+    break;
+  }
+  case Command::Kind::Text: {
+    auto const& fonts = RasterFonts::instance();
+    float const scale = cmd.fontsize / cmd.font->FontSize;
+    float const lineHeight = cmd.fontsize;
+    auto        pos   = Vec2{std::floor(cmd.pmin.x), std::floor(cmd.pmin.y)};
+    float const left  = pos.x;
+    char const* s     = cmd.text.data();
+    char const* end   = s + cmd.text.size();
+    while (s < end) {
+      unsigned int c = static_cast<unsigned char>(*s);
+      if (c < 0x80)
+        ++s;
+      else
+        s += ImTextCharFromUtf8(&c, s, end);
+      if (c == '\n') {
+        pos.x = left;
+        pos.y += lineHeight;
+        continue;
+      }
+      if (c == '\r')
+        continue;
+      auto const* glyph = cmd.font->FindGlyph(static_cast<ImWchar>(c));
+      if (!glyph)
+        continue;
+      if (glyph->Visible) {
+        float const gx0 = pos.x + glyph->X0 * scale, gy0 = pos.y + glyph->Y0 * scale;
+        float const gx1 = pos.x + glyph->X1 * scale, gy1 = pos.y + glyph->Y1 * scale;
+        int const   px0 = std::max(0, int(std::floor(gx0))), py0 = std::max(0, int(std::floor(gy0)));
+        int const   px1 = std::min(width_, int(std::ceil(gx1))),
+                  py1 = std::min(height_, int(std::ceil(gy1)));
+        float const du = (glyph->U1 - glyph->U0) * fonts.width / (gx1 - gx0);
+        float const dv = (glyph->V1 - glyph->V0) * fonts.height / (gy1 - gy0);
+        for (int py = py0; py < py1; ++py) {
+          float const ty = glyph->V0 * fonts.height + (py + 0.5f - gy0) * dv;
+          for (int px = px0; px < px1; ++px) {
+            float const tx = glyph->U0 * fonts.width + (px + 0.5f - gx0) * du;
+            if (float const a = fonts.sample(tx, ty); a > 0.f)
+              blendPixel(pixels_.data() + (size_t(py) * width_ + px) * 4, cmd.color, a);
+          }
+        }
+      }
+      pos.x += glyph->AdvanceX * scale;
+    }
+    break;
+  }
+  case Command::Kind::Image: {
+    auto const* img = dynamic_cast<RasterImage const*>(cmd.image.get());
+    auto        pmin = cmd.pmin, pmax = cmd.pmax;
+    auto        uvmin = cmd.uvmin, uvmax = cmd.uvmax;
+    if (pmin.x > pmax.x) {
+      std::swap(pmin.x, pmax.x);
+      std::swap(uvmin.x, uvmax.x);
+    }
+    if (pmin.y > pmax.y) {
+      std::swap(pmin.y, pmax.y);
+      std::swap(uvmin.y, uvmax.y);
+    }
+    if (!img || img->width <= 0 || img->height <= 0) { // not drawable here, leave a placeholder
+      scratch_.clear();
+      roundRectPath(pmin, pmax, 0, scratch_);
+      rasterizer_->reset();
+      rasterizer_->addPolygon(scratch_.data(), scratch_.size());
+      rasterizer_->fill(pixels_.data(), width_, height_, 0x808080ff);
+      break;
+    }
+    int const px0 = std::max(0, int(std::floor(pmin.x))), py0 = std::max(0, int(std::floor(pmin.y)));
+    int const px1 = std::min(width_, int(std::ceil(pmax.x))),
+              py1 = std::min(height_, int(std::ceil(pmax.y)));
+    for (int py = py0; py < py1; ++py) {
+      float const v  = uvmin.y + (py + 0.5f - pmin.y) / (pmax.y - pmin.y) * (uvmax.y - uvmin.y);
+      int const   ty = std::clamp(int(v * img->height), 0, img->height - 1);
+      for (int px = px0; px < px1; ++px) {
+        float const u  = uvmin.x + (px + 0.5f - pmin.x) / (pmax.x - pmin.x) * (uvmax.x - uvmin.x);
+        int const   tx = std::clamp(int(u * img->width), 0, img->width - 1);
+        auto const* src = img->pixels.data() + (size_t(ty) * img->width + tx) * 4;
+        uint32_t const color = uint32_t(src[0]) << 24 | uint32_t(src[1]) << 16 |
+                               uint32_t(src[2]) << 8 | uint32_t(src[3]);
+        blendPixel(pixels_.data() + (size_t(py) * width_ + px) * 4, color, 1.f);
+      }
+    }
+    break;
+  }
+  }
+}
+
+Vector<uint8_t> RasterCanvas::encodePNG() const
+{
+  size_t size = 0;
+  void*  data = tdefl_write_image_to_png_file_in_memory(pixels_.data(), width_, height_, 4, &size);
+  if (!data)
+    return {};
+  Vector<uint8_t> result(static_cast<uint8_t*>(data), static_cast<uint8_t*>(data) + size);
+  mz_free(data);
+  return result;
+}
+
+bool RasterCanvas::savePNG(String const& path) const
+{
+  auto png = encodePNG();
+  if (png.empty()) {
+    msghub::errorf("failed to encode {}x{} image as png", width_, height_);
+    return false;
+  }
+  std::ofstream file(path, std::ios::binary);
+  if (!file) {
+    msghub::errorf("can't open {} for writing", path);
+    return false;
+  }
+  file.write(reinterpret_cast<char const*>(png.data()), png.size());
+  return file.good();
+}
+
+Canvas::ImagePtr RasterCanvas::createRasterImage(uint8_t const* data, int width, int height)
+{
+  auto img    = std::make_shared<RasterImage>();
+  img->width  = width;
+  img->height = height;
+  img->pixels.assign(data, data + size_t(width) * height * 4);
+  return img;
+}
+
+void RasterCanvas::drawGraph(Graph* graph, float margin)
+{
+  if (!graph)
+    return;
+  AABB                bb;
+  Vector<GraphItem*>  items;
+  graph->forEachItemRaw([&bb, &items](GraphItem* item) {
+    bb.merge(item->aabb());
+    items.push_back(item);
+  });
+  if (items.empty())
+    return;
+  auto const avail = Vec2{std::max(width_ - margin * 2, 1.f), std::max(height_ - margin * 2, 1.f)};
+  auto const scale = gmath::clamp(
+    std::min(avail.x / std::max(bb.width(), 1.f), avail.y / std::max(bb.height(), 1.f)),
+    0.02f,
+    2.f);
+  setViewScale(scale);
+  setViewPos(bb.center() * scale);
+
+  std::stable_sort(items.begin(), items.end(), [](GraphItem* a, GraphItem* b) {
+    return a->zOrder() < b->zOrder();
+  });
+  auto const vp = viewport();
+  pushLayer(Layer::Standard);
+  for (auto* item : items)
+    if (vp.intersects(item->aabb()))
+      item->draw(this, GraphItemState::DEFAULT);
+  popLayer();
+}
+
+// recording {{{
+void RasterCanvas::addFill(Vec2 const* pts, sint numpt, uint32_t color) const
+{
+  if (numpt < 3 || (color & 0xff) == 0)
+    return;
+  Command cmd{Command::Kind::Fill, color};
+  cmd.firstPolygon = polygons_.size();
+  cmd.firstPoint   = points_.size();
+  cmd.numPolygons  = 1;
+  points_.insert(points_.end(), pts, pts + numpt);
+  polygons_.push_back(numpt);
+  commands_[static_cast<int>(layer_)].push_back(std::move(cmd));
+}
+
+void RasterCanvas::addStroke(Vec2 const* pts, sint numpt, bool closed, float width, uint32_t color)
+  const
+{
+  if (numpt < 2 || width <= 0.f)
+    return;
+  // hairlines are drawn 1px wide and fainter
+  color = scaleAlpha(color, std::min(width, 1.f));
+  width = std::max(width, 1.f);
+  if ((color & 0xff) == 0)
+    return;
+
+  Command cmd{Command::Kind::Fill, color};
+  cmd.firstPolygon = polygons_.size();
+  cmd.firstPoint   = points_.size();
+  float const halfw = width * 0.5f;
+  sint const  nseg  = closed ? numpt : numpt - 1;
+  for (sint i = 0; i < nseg; ++i) {
+    auto const a = pts[i], b = pts[(i + 1) % numpt];
+    auto const d = b - a;
+    if (length2(d) < 1e-8f)
+      continue;
+    auto const n = Vec2{-d.y, d.x} * (halfw / length(d));
+    points_.insert(points_.end(), {a + n, b + n, b - n, a - n});
+    polygons_.push_back(4);
+    ++cmd.numPolygons;
+  }
+  // round joins, only visible on thicker strokes
+  if (width > 2.f) {
+    for (sint i = closed ? 0 : 1, n = closed ? numpt : numpt - 1; i < n; ++i) {
+      auto const before = points_.size();
+      circlePath(pts[i], halfw, 8, points_);
+      polygons_.push_back(points_.size() - before);
+      ++cmd.numPolygons;
+    }
+  }
+  if (cmd.numPolygons > 0)
+    commands_[static_cast<int>(layer_)].push_back(std::move(cmd));
+}
+
+void RasterCanvas::addShape(Vec2 const* pts, sint numpt, bool closed, ShapeStyle const& style) const
+{
+  if (closed && style.filled)
+    addFill(pts, numpt, style.fillColor);
+  if (style.strokeWidth * viewScale_ > 0.1f)
+    addStroke(pts, numpt, closed, style.strokeWidth * viewScale_, style.strokeColor);
+}
+
+void RasterCanvas::addText(Vec2 pos, StringView text, TextStyle const& style, float scale) const
+{
+  if (text.empty() || (style.color & 0xff) == 0)
+    return;
+  auto const* font     = RasterFonts::instance().match(style, scale);
+  float const fontsize = floatFontSize(style.size) * scale;
+  if (!font || fontsize < 1.f)
+    return;
+  if (style.align != TextAlign::Left || style.valign != TextVerticalAlign::Top) {
+    auto size = font->CalcTextSizeA(fontsize, FLT_MAX, 0.f, text.data(), text.data() + text.size());
+    if (style.align == TextAlign::Center)
+      pos.x -= size.x / 2.f;
+    else if (style.align == TextAlign::Right)
+      pos.x -= size.x;
+    if (style.valign == TextVerticalAlign::Center)
+      pos.y -= size.y / 2.f;
+    else if (style.valign == TextVerticalAlign::Bottom)
+      pos.y -= size.y;
+  }
+  Command cmd{Command::Kind::Text, style.color};
+  cmd.text     = String(text);
+  cmd.font     = font;
+  cmd.fontsize = fontsize;
+  cmd.pmin     = pos;
+  commands_[static_cast<int>(layer_)].push_back(std::move(cmd));
+}
+// }}} recording
+
+// Canvas interface {{{
+Vec2 RasterCanvas::measureTextSize(StringView text, TextStyle const& style) const
+{
+  auto const* font     = RasterFonts::instance().match(style, viewScale_);
+  float const fontsize = floatFontSize(style.size);
+  auto        size =
+    font->CalcTextSizeA(fontsize, FLT_MAX, 0.f, text.data(), text.data() + text.size());
+  return Vec2{size.x, size.y};
+}
+
+void RasterCanvas::setCurrentLayer(Layer layer)
+{
+  layer_ = layer;
+}
+
+void RasterCanvas::drawLine(Vec2 a, Vec2 b, uint32_t color, float width) const
+{
+  Vec2 const pts[] = {canvasToScreen_.transformPoint(a), canvasToScreen_.transformPoint(b)};
+  addStroke(pts, 2, false, width * viewScale_, color);
+}
+
+void RasterCanvas::drawRect(Vec2 topleft, Vec2 bottomright, float cornerradius, ShapeStyle style)
+  const
+{
+  scratch_.clear();
+  roundRectPath(
+    canvasToScreen_.transformPoint(topleft),
+    canvasToScreen_.transformPoint(bottomright),
+    cornerradius * viewScale_,
+    scratch_);
+  addShape(scratch_.data(), scratch_.size(), true, style);
+}
+
+void RasterCanvas::drawCircle(Vec2 center, float radius, int nsegments, ShapeStyle style) const
+{
+  scratch_.clear();
+  circlePath(canvasToScreen_.transformPoint(center), radius * viewScale_, nsegments, scratch_);
+  addShape(scratch_.data(), scratch_.size(), true, style);
+}
+
+void RasterCanvas::drawPoly(Vec2 const* pts, sint numpt, bool closed, ShapeStyle style) const
+{
+  scratch_.resize(numpt);
+  canvasToScreen_.transformPoints(pts, scratch_.data(), numpt);
+  addShape(scratch_.data(), numpt, closed, style);
+}
+
+void RasterCanvas::drawText(Vec2 pos, StringView text, TextStyle const& style) const
+{
+  addText(canvasToScreen_.transformPoint(pos), text, style, viewScale_);
+}
+
+void RasterCanvas::drawTextUntransformed(
+  Vec2             pos,
+  StringView       text,
+  TextStyle const& style,
+  float            scale) const
+{
+  addText(pos, text, style, scale);
+}
+
+void RasterCanvas::drawImage(ImagePtr image, Vec2 pmin, Vec2 pmax, Vec2 uvmin, Vec2 uvmax) const
+{
+  Command cmd{Command::Kind::Image};
+  cmd.image = image;
+  cmd.pmin  = canvasToScreen_.transformPoint(pmin);
+  cmd.pmax  = canvasToScreen_.transformPoint(pmax);
+  cmd.uvmin = uvmin;
+  cmd.uvmax = uvmax;
+  commands_[static_cast<int>(layer_)].push_back(std::move(cmd));
+}
+// }}} Canvas interface
+// }}} Raster Canvas
+
+} // namespace nged
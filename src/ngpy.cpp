@@ -7,6 +7,7 @@
 #include <nged/pybind11_imgui.h>
 
 // from parmscript:
+#include <binparm.h>
 #include <jsonparm.h>
 #include <pyparm.h>
 #include <inspectorext.h>
@@ -30,6 +31,8 @@
 #include <pybind11/functional.h>
 #include <pybind11/numpy.h>
 
+#include <chrono>
+#include <cmath>
 #include <iostream>
 
 namespace py = pybind11;
@@ -144,27 +147,25 @@ bool PyNode::serialize(nged::Json& json) const
       return false;
   }
 
-  if (!parmInspector.empty())
-    to_json(json["parms"], parmInspector.parms());
-  else
+  if (parmInspector.empty()) {
     json["parms"] = nullptr;
+  } else if (parent() && parent()->docRoot() && parent()->docRoot()->binarySerialization()) {
+    std::vector<uint8_t> blob;
+    to_binary(blob, parmInspector.parms());
+    json["parms"] = nged::Json::binary(std::move(blob));
+  } else {
+    to_json(json["parms"], parmInspector.parms());
+  }
   if (!extraParms.empty())
     json["extraParms"] = extraParms;
-  try {
-    pybind11::gil_scoped_acquire gil;
-    auto pyserialize = pybind11::get_override(this, "serialize");
-    if (pyserialize) {
-      auto pystr = pyserialize();
-      if (pystr.is_none())
-        return false;
-      json["pynode"] = pystr.cast<std::string>();
-    } else {
-      json["pynode"] = "";
-    }
-  } catch (std::exception const& e) {
-    msghub::errorf("failed to serialize node {}: {}", name(), e.what());
+  PySerialized state;
+  if (!pyTakeSerialized(parent(), this, state))
+    state = pySerialize();
+  if (!state.ok) {
+    msghub::errorf("failed to serialize node {}", name());
     return false;
   }
+  json["pynode"] = std::move(state.data);
   return true;
 }
 
@@ -191,24 +192,24 @@ bool PyNode::deserialize(nged::Json const& json)
   } else {
     parmInspector.setParms(nullptr);
   }
-  if (!parmInspector.empty())
-    from_json(json["parms"], parmInspector.parms());
-  try {
-    pybind11::gil_scoped_acquire gil;
-    auto pydeserialize = pybind11::get_override(this, "deserialize");
-    if (pydeserialize) {
-      auto pystr = json.value("pynode", "");
-      pydeserialize(pystr);
-    }
-  } catch (std::exception const& e) {
-    msghub::errorf("failed to deserialize node {}: {}", name(), e.what());
-    return false;
+  if (!parmInspector.empty()) {
+    auto const& parms = json["parms"];
+    if (!parms.is_binary())
+      from_json(parms, parmInspector.parms());
+    else if (!from_binary(parms.get_binary(), parmInspector.parms()))
+      msghub::errorf("failed to load parms of node {}, keeping their defaults", name());
   }
-
-  return true;
+  return pyCallOrDefer(parent(), this, [pystr = json.value("pynode", "")](PyNode* self) {
+    return self->pyDeserialize(pystr);
+  });
 }
 
 void PyNode::settled()
+{
+  pyCallOrDefer(parent(), this, [](PyNode* self) { return self->pySettled(); });
+}
+
+bool PyNode::pySettled()
 {
   try {
     pybind11::gil_scoped_acquire gil;
@@ -219,6 +220,7 @@ void PyNode::settled()
   } catch (std::exception const& e) {
     msghub::errorf("failed to call settled on node {}: {}", name(), e.what());
   }
+  return true;
 }
 
 size_t PyNode::getExtraDependencies(nged::Vector<nged::ItemID>& deps)
@@ -246,31 +248,46 @@ bool PyGraph::serialize(nged::Json& json) const
 {
   if (!Graph::serialize(json))
     return false;
+  PySerialized state;
+  if (!pyTakeSerialized(this, this, state))
+    state = pySerialize();
+  json["pygraph"] = std::move(state.data);
+  return state.ok;
+}
+
+bool PyGraph::deserialize(nged::Json const& json)
+{
+  if (!Graph::deserialize(json))
+    return false;
+  return pyCallOrDefer(this, this, [pystr = json.value("pygraph", "")](PyGraph* self) {
+    return self->pyDeserialize(pystr);
+  });
+}
+
+PySerialized PyGraph::pySerialize() const
+{
+  PySerialized state;
   try {
     py::gil_scoped_acquire gil;
     auto pyserialize = py::get_override(this, "serialize");
     if (pyserialize) {
-      auto pystr = pyserialize();
-      json["pygraph"] = pystr.cast<std::string_view>();
-    } else {
-      json["pygraph"] = "";
+      state.overridden = true;
+      state.data = pyserialize().cast<std::string>();
     }
-    return true;
   } catch (std::exception const& e) {
     msghub::errorf("error serilizing graph: {}", e.what());
-    return false;
+    state.ok = false;
   }
+  return state;
 }
 
-bool PyGraph::deserialize(nged::Json const& json)
+bool PyGraph::pyDeserialize(std::string const& pystr)
 {
-  if (!Graph::deserialize(json))
-    return false;
   try {
     py::gil_scoped_acquire gil;
     auto pydeserialize = py::get_override(this, "deserialize");
     if (pydeserialize) {
-      pydeserialize(json.value("pygraph", ""));
+      pydeserialize(pystr);
     }
     return true;
   } catch (std::exception const& e) {
@@ -280,6 +297,101 @@ bool PyGraph::deserialize(nged::Json const& json)
 }
 // }}}
 
+// --------------------------------------- PyNodeGraphDoc --------------------------------------------------
+// PyNodeGraphDoc {{{
+static PyNodeGraphDoc* pyDocOf(nged::Graph const* graph)
+{
+  if (!graph || !graph->docRoot())
+    return nullptr;
+  assert(dynamic_cast<PyNodeGraphDoc*>(graph->docRoot()));
+  return static_cast<PyNodeGraphDoc*>(graph->docRoot());
+}
+
+bool pyTakeSerialized(nged::Graph const* graph, void const* obj, PySerialized& state)
+{
+  auto* doc = pyDocOf(graph);
+  return doc && doc->takePySerialized(obj, state);
+}
+
+bool pyDeferCall(nged::Graph const* graph, std::function<bool()> call)
+{
+  auto* doc = pyDocOf(graph);
+  return doc && doc->deferPyCall(std::move(call));
+}
+
+bool PyNodeGraphDoc::takePySerialized(void const* obj, PySerialized& state)
+{
+  if (auto itr = pySerialized_.find(obj); itr != pySerialized_.end()) {
+    state = std::move(itr->second);
+    pySerialized_.erase(itr);
+    return true;
+  }
+  return false;
+}
+
+bool PyNodeGraphDoc::deferPyCall(std::function<bool()> call)
+{
+  if (!pyDeferring_)
+    return false;
+  pyDeferredCalls_.push_back(std::move(call));
+  return true;
+}
+
+bool PyNodeGraphDoc::serializeGraph(nged::Graph const* graph, nged::Json& json)
+{
+  if (!pyBatching_)
+    return nged::NodeGraphDoc::serializeGraph(graph, json);
+  {
+    py::gil_scoped_acquire gil;
+    nged::HashSet<nged::Graph const*> graphs = {graph};
+    pool().foreach([this, &graphs](nged::GraphItemPtr const& item) {
+      if (auto const* node = dynamic_cast<PyNode const*>(item.get()))
+        pySerialized_[node] = node->pySerialize();
+      else if (auto const* pyitem = dynamic_cast<PyGraphItem const*>(item.get()))
+        pySerialized_[pyitem] = pyitem->pySerialize();
+      graphs.insert(item->parent());
+    });
+    for (auto const* g : graphs)
+      if (auto const* pygraph = dynamic_cast<PyGraph const*>(g))
+        pySerialized_[pygraph] = pygraph->pySerialize();
+  }
+  // states of items that `graph` does not reach are dropped afterwards
+  bool succeed = false;
+  try {
+    succeed = nged::NodeGraphDoc::serializeGraph(graph, json);
+  } catch (...) {
+    pySerialized_.clear();
+    throw;
+  }
+  pySerialized_.clear();
+  return succeed;
+}
+
+bool PyNodeGraphDoc::deserializeGraph(nged::Graph* graph, nged::Json const& json)
+{
+  if (pyDeferring_ || !pyBatching_)
+    return nged::NodeGraphDoc::deserializeGraph(graph, json);
+  bool succeed = false;
+  pyDeferring_ = true;
+  try {
+    succeed = nged::NodeGraphDoc::deserializeGraph(graph, json);
+  } catch (...) {
+    pyDeferring_ = false;
+    pyDeferredCalls_.clear();
+    throw;
+  }
+  pyDeferring_ = false;
+  auto calls = std::move(pyDeferredCalls_);
+  pyDeferredCalls_.clear();
+  if (!calls.empty()) {
+    py::gil_scoped_acquire gil;
+    for (auto& call : calls)
+      succeed = call() && succeed;
+  }
+  return succeed;
+}
+// }}}
+
 // --------------------------------------- PyNodeFactory --------------------------------------------------
 // PyNodeFactory {{{
 nged::GraphPtr PyNodeFactory::createRootGraph(nged::NodeGraphDoc* doc) const
@@ -466,6 +578,78 @@ std::shared_ptr<PyImGuiNodeGraphEditor> createEditor(py::object docFactory, py::
 //}}}
 
 // Responser {{{
+struct PyResponser::HookTimer
+{
+  HookStats&                            stats;
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+  HookTimer(HookStats& stats) : stats(stats) {}
+  ~HookTimer()
+  {
+    ++stats.calls;
+    stats.seconds +=
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+};
+
+char const* PyResponser::hookName(Hook hook)
+{
+  static char const* names[] = {
+    "onInspect", "beforeItemAdded", "afterItemAdded", "beforeItemRemoved",
+    "beforeNodeRenamed", "afterNodeRenamed", "beforeViewUpdate", "afterViewUpdate",
+    "beforeViewDraw", "afterViewDraw", "onItemClicked", "onItemDoubleClicked",
+    "onItemHovered", "onSelectionChanged", "beforeLinkSet", "onLinkSet",
+    "onLinkRemoved", "afterPaste"};
+  static_assert(sizeof(names) / sizeof(names[0]) == static_cast<int>(Hook::Count));
+  return names[static_cast<int>(hook)];
+}
+
+py::function& PyResponser::hookCallback(Hook hook)
+{
+  switch (hook) {
+  case Hook::OnInspect: return pyOnInspectCallback;
+  case Hook::BeforeItemAdded: return pyBeforeItemAddedCallback;
+  case Hook::AfterItemAdded: return pyAfterItemAddedCallback;
+  case Hook::BeforeItemRemoved: return pyBeforeItemRemovedCallback;
+  case Hook::BeforeNodeRenamed: return pyBeforeNodeRenamedCallback;
+  case Hook::AfterNodeRenamed: return pyAfterNodeRenamedCallback;
+  case Hook::BeforeViewUpdate: return pyBeforeViewUpdateCallback;
+  case Hook::AfterViewUpdate: return pyAfterViewUpdateCallback;
+  case Hook::BeforeViewDraw: return pyBeforeViewDrawCallback;
+  case Hook::AfterViewDraw: return pyAfterViewDrawCallback;
+  case Hook::OnItemClicked: return pyOnItemClickedCallback;
+  case Hook::OnItemDoubleClicked: return pyOnItemDoubleClickedCallback;
+  case Hook::OnItemHovered: return pyOnItemHoveredCallback;
+  case Hook::OnSelectionChanged: return pyOnSelectionChangedCallback;
+  case Hook::BeforeLinkSet: return pyBeforeLinkSetCallback;
+  case Hook::OnLinkSet: return pyOnLinkSetCallback;
+  case Hook::OnLinkRemoved: return pyOnLinkRemovedCallback;
+  case Hook::AfterPaste: return pyAfterPasteCallback;
+  default: break;
+  }
+  throw std::out_of_range("bad responser hook");
+}
+
+void PyResponser::setPyResponder(py::object responder)
+{
+  for (int i = 0; i < static_cast<int>(Hook::Count); ++i) {
+    auto  hook     = static_cast<Hook>(i);
+    auto& callback = hookCallback(hook);
+    callback       = py::function();
+    if (!responder.is_none() && py::hasattr(responder, hookName(hook))) {
+      py::object method = responder.attr(hookName(hook));
+      if (PyCallable_Check(method.ptr()))
+        callback = method.cast<py::function>();
+    }
+  }
+}
+
+void PyResponser::resetHookStats()
+{
+  for (auto& stats : hookStats_)
+    stats = {};
+}
+
 void PyResponser::onInspect(nged::InspectorView* view, nged::GraphItem** items, size_t count)
 {
   bool  handled  = false;
@@ -508,6 +692,7 @@ void PyResponser::onInspect(nged::InspectorView* view, nged::GraphItem** items,
 
   if (pyOnInspectCallback && count != 0) {
     try {
+      HookTimer timer(hookStats_[static_cast<int>(Hook::OnInspect)]);
       py::gil_scoped_acquire gil;
       py::tuple pyitems(count);
       for (size_t i=0; i<count; ++i)
@@ -547,6 +732,7 @@ bool PyResponser::beforeItemAdded(nged::Graph* graph, nged::GraphItem* item, nge
 {
   if (pyBeforeItemAddedCallback) {
     try {
+      HookTimer timer(hookStats_[static_cast<int>(Hook::BeforeItemAdded)]);
       py::gil_scoped_acquire gil;
       auto ret = pyBeforeItemAddedCallback(graph, item);
       if (py::isinstance<py::bool_>(ret)) {
@@ -575,6 +761,7 @@ void PyResponser::afterItemAdded(nged::Graph* graph, nged::GraphItem* item)
 {
   if (pyAfterItemAddedCallback) {
     try {
+      HookTimer timer(hookStats_[static_cast<int>(Hook::AfterItemAdded)]);
       py::gil_scoped_acquire gil;
       pyAfterItemAddedCallback(graph, item);
       return;
@@ -589,6 +776,7 @@ bool PyResponser::beforeItemRemoved(nged::Graph* graph, nged::GraphItem* item)
 {
   if (pyBeforeItemRemovedCallback) {
     try {
+      HookTimer timer(hookStats_[static_cast<int>(Hook::BeforeItemRemoved)]);
       py::gil_scoped_acquire gil;
       return pybind11::cast<bool>(pyBeforeItemRemovedCallback(graph, item));
     } catch (std::exception const& e) {
@@ -602,6 +790,7 @@ bool PyResponser::beforeNodeRenamed(nged::Graph* graph, nged::Node* node)
 {
   if (pyBeforeNodeRenamedCallback) {
     try {
+      HookTimer timer(hookStats_[static_cast<int>(Hook::BeforeNodeRenamed)]);
       py::gil_scoped_acquire gil;
       return pybind11::cast<bool>(pyBeforeNodeRenamedCallback(graph, node));
     } catch (std::exception const& e) {
@@ -615,6 +804,7 @@ void PyResponser::afterNodeRenamed(nged::Graph* graph, nged::Node* node)
 {
   if (pyAfterNodeRenamedCallback) {
     try {
+      HookTimer timer(hookStats_[static_cast<int>(Hook::AfterNodeRenamed)]);
       py::gil_scoped_acquire gil;
       pyAfterNodeRenamedCallback(graph, node);
       return;
@@ -629,6 +819,7 @@ void PyResponser::beforeViewUpdate(nged::GraphView* view)
 {
   if (pyBeforeViewUpdateCallback) {
     try {
+      HookTimer timer(hookStats_[static_cast<int>(Hook::BeforeViewUpdate)]);
       py::gil_scoped_acquire gil;
       pyBeforeViewUpdateCallback(view);
       return;
@@ -643,6 +834,7 @@ void PyResponser::afterViewUpdate(nged::GraphView* view)
 {
   if (pyAfterViewUpdateCallback) {
     try {
+      HookTimer timer(hookStats_[static_cast<int>(Hook::AfterViewUpdate)]);
       py::gil_scoped_acquire gil;
       pyAfterViewUpdateCallback(view);
       return;
@@ -657,6 +849,7 @@ void PyResponser::beforeViewDraw(nged::GraphView* view)
 {
   if (pyBeforeViewDrawCallback) {
     try {
+      HookTimer timer(hookStats_[static_cast<int>(Hook::BeforeViewDraw)]);
       py::gil_scoped_acquire gil;
       pyBeforeViewDrawCallback(view);
       return;
@@ -671,6 +864,7 @@ void PyResponser::afterViewDraw(nged::GraphView* view)
 {
   if (pyAfterViewDrawCallback) {
     try {
+      HookTimer timer(hookStats_[static_cast<int>(Hook::AfterViewDraw)]);
       py::gil_scoped_acquire gil;
       pyAfterViewDrawCallback(view);
       return;
@@ -685,6 +879,7 @@ void PyResponser::onItemClicked(nged::NetworkView* view, nged::GraphItem* item,
 {
   if (pyOnItemClickedCallback) {
     try {
+      HookTimer timer(hookStats_[static_cast<int>(Hook::OnItemClicked)]);
       py::gil_scoped_acquire gil;
       pyOnItemClickedCallback(view, item, button);
       return;
@@ -699,6 +894,7 @@ void PyResponser::onItemDoubleClicked(nged::NetworkView* view, nged::GraphItem*
 {
   if (pyOnItemDoubleClickedCallback) {
     try {
+      HookTimer timer(hookStats_[static_cast<int>(Hook::OnItemDoubleClicked)]);
       py::gil_scoped_acquire gil;
       pyOnItemDoubleClickedCallback(view, item, button);
       return;
@@ -713,6 +909,7 @@ void PyResponser::onItemHovered(nged::NetworkView* view, nged::GraphItem* item)
 {
   if (pyOnItemHoveredCallback) {
     try {
+      HookTimer timer(hookStats_[static_cast<int>(Hook::OnItemHovered)]);
       py::gil_scoped_acquire gil;
       pyOnItemHoveredCallback(view, item);
       return;
@@ -727,6 +924,7 @@ void PyResponser::onSelectionChanged(nged::NetworkView* view)
 {
   if (pyOnSelectionChangedCallback) {
     try {
+      HookTimer timer(hookStats_[static_cast<int>(Hook::OnSelectionChanged)]);
       py::gil_scoped_acquire gil;
       pyOnSelectionChangedCallback(view);
       return;
@@ -741,6 +939,7 @@ bool PyResponser::beforeLinkSet(nged::Graph* graph, nged::InputConnection src, n
 {
   if (pyBeforeLinkSetCallback) {
     try {
+      HookTimer timer(hookStats_[static_cast<int>(Hook::BeforeLinkSet)]);
       py::gil_scoped_acquire gil;
       return pybind11::cast<bool>(pyBeforeLinkSetCallback(graph, src.sourceItem, src.sourcePort, dst.destItem, dst.destPort));
     } catch (std::exception const& e) {
@@ -754,6 +953,7 @@ void PyResponser::onLinkSet(nged::Link* link)
 {
   if (pyOnLinkSetCallback) {
     try {
+      HookTimer timer(hookStats_[static_cast<int>(Hook::OnLinkSet)]);
       py::gil_scoped_acquire gil;
       pyOnLinkSetCallback(link);
       return;
@@ -768,6 +968,7 @@ void PyResponser::onLinkRemoved(nged::Link* link)
 {
   if (pyOnLinkRemovedCallback) {
     try {
+      HookTimer timer(hookStats_[static_cast<int>(Hook::OnLinkRemoved)]);
       py::gil_scoped_acquire gil;
       pyOnLinkRemovedCallback(link);
       return;
@@ -782,6 +983,7 @@ void PyResponser::afterPaste(nged::Graph* graph, nged::GraphItem** items, size_t
 {
   if (pyAfterPasteCallback) {
     try {
+      HookTimer timer(hookStats_[static_cast<int>(Hook::AfterPaste)]);
       py::gil_scoped_acquire gil;
       py::list newitems;
       for(size_t i=0; i<count; ++i)
@@ -833,6 +1035,220 @@ nged::GraphViewPtr PyViewFactory::createView(nged::String const& kind, nged::Nod
 }
 // }}}
 
+// --------------------------------------- Bulk Graph Access --------------------------------------------------
+// Bulk Graph Access {{{
+// `ids` may be None (all items of the graph), an uint64 array or any iterable of ItemIDs;
+// results are NumPy arrays in the same order, so scripts can work on whole graphs vectorized
+using BulkIds = py::array_t<uint64_t, py::array::c_style | py::array::forcecast>;
+
+static nged::Vector<nged::ItemID> bulkResolveIds(nged::Graph* graph, py::object ids)
+{
+  nged::Vector<nged::ItemID> result;
+  if (ids.is_none()) {
+    result.reserve(graph->items().size());
+    for (auto id: graph->items())
+      result.push_back(id);
+  } else if (py::isinstance<py::array>(ids)) {
+    auto arr = ids.cast<BulkIds>();
+    auto const* data = arr.data();
+    result.assign(data, data + arr.size());
+  } else {
+    for (auto id: ids)
+      result.push_back(id.cast<nged::ItemID>());
+  }
+  return result;
+}
+
+// slot of `id` in the item pool's hot fields, or -1 if it's not an item of `graph`
+static int64_t bulkSlot(nged::Graph* graph, nged::GraphItemPool::HotFields const& hot, nged::ItemID id)
+{
+  auto idx = id.index();
+  if (idx < hot.size() && hot.id[idx] == id && hot.parent[idx] == graph)
+    return idx;
+  return -1;
+}
+
+static py::array_t<uint64_t> bulkItemIds(nged::Graph* graph)
+{
+  py::array_t<uint64_t> result(graph->items().size());
+  auto* out = result.mutable_data();
+  for (auto id: graph->items())
+    *out++ = id.value();
+  return result;
+}
+
+static py::array_t<float> bulkPositions(nged::Graph* graph, py::object ids)
+{
+  auto const& hot = graph->docRoot()->pool().hotFields();
+  auto idlist = bulkResolveIds(graph, ids);
+  py::array_t<float> result({py::ssize_t(idlist.size()), py::ssize_t(2)});
+  auto* out = result.mutable_data();
+  for (auto id: idlist) {
+    auto slot = bulkSlot(graph, hot, id);
+    *out++ = slot < 0 ? NAN : hot.pos[slot].x;
+    *out++ = slot < 0 ? NAN : hot.pos[slot].y;
+  }
+  return result;
+}
+
+static py::array_t<float> bulkBounds(nged::Graph* graph, py::object ids)
+{
+  auto const& hot = graph->docRoot()->pool().hotFields();
+  auto idlist = bulkResolveIds(graph, ids);
+  py::array_t<float> result({py::ssize_t(idlist.size()), py::ssize_t(4)});
+  auto* out = result.mutable_data();
+  for (auto id: idlist) {
+    auto slot = bulkSlot(graph, hot, id);
+    if (slot < 0) {
+      for (int i = 0; i < 4; ++i)
+        *out++ = NAN;
+    } else {
+      auto const& bb = hot.bounds[slot];
+      *out++ = bb.min.x;
+      *out++ = bb.min.y;
+      *out++ = bb.max.x;
+      *out++ = bb.max.y;
+    }
+  }
+  return result;
+}
+
+static py::array_t<uint8_t> bulkKinds(nged::Graph* graph, py::object ids)
+{
+  auto const& hot = graph->docRoot()->pool().hotFields();
+  auto idlist = bulkResolveIds(graph, ids);
+  py::array_t<uint8_t> result(idlist.size());
+  auto* out = result.mutable_data();
+  for (auto id: idlist) {
+    auto slot = bulkSlot(graph, hot, id);
+    *out++ = static_cast<uint8_t>(slot < 0 ? nged::ItemKind::None : hot.kind[slot]);
+  }
+  return result;
+}
+
+static py::array_t<uint64_t> bulkFlags(nged::Graph* graph, py::object ids)
+{
+  auto const& hot = graph->docRoot()->pool().hotFields();
+  auto idlist = bulkResolveIds(graph, ids);
+  py::array_t<uint64_t> result(idlist.size());
+  auto* out = result.mutable_data();
+  for (auto id: idlist) {
+    auto slot = bulkSlot(graph, hot, id);
+    auto* node = slot < 0 ? nullptr : hot.item[slot]->asNode();
+    *out++ = node ? node->flags() : 0;
+  }
+  return result;
+}
+
+// node types, categorical: (int32 codes, [type names]), code is -1 for non-nodes
+static py::tuple bulkNodeTypes(nged::Graph* graph, py::object ids)
+{
+  auto const& hot = graph->docRoot()->pool().hotFields();
+  auto idlist = bulkResolveIds(graph, ids);
+  nged::HashMap<nged::String, int32_t> codes;
+  py::list names;
+  py::array_t<int32_t> result(idlist.size());
+  auto* out = result.mutable_data();
+  for (auto id: idlist) {
+    auto slot = bulkSlot(graph, hot, id);
+    auto* node = slot < 0 ? nullptr : hot.item[slot]->asNode();
+    if (!node) {
+      *out++ = -1;
+      continue;
+    }
+    auto [itr, inserted] = codes.insert({node->type(), static_cast<int32_t>(codes.size())});
+    if (inserted)
+      names.append(node->type());
+    *out++ = itr->second;
+  }
+  return py::make_tuple(result, names);
+}
+
+// wraps `data` without copying, `owner` is kept alive by the array
+template <class T>
+static py::array bulkReadonlyView(
+  py::handle owner, void const* data, std::vector<size_t> shape, std::vector<size_t> strides)
+{
+  std::vector<py::ssize_t> pyshape(shape.begin(), shape.end());
+  std::vector<py::ssize_t> pystrides(strides.begin(), strides.end());
+  py::array view(py::dtype::of<T>(), pyshape, pystrides, data, owner);
+  view.attr("setflags")(py::arg("write") = false);
+  return view;
+}
+
+static size_t bulkSetPositions(nged::Graph* graph, py::object ids, py::array_t<float, py::array::c_style | py::array::forcecast> positions)
+{
+  auto idlist = bulkResolveIds(graph, ids);
+  if (positions.ndim() != 2 || positions.shape(1) != 2 || size_t(positions.shape(0)) != idlist.size())
+    throw py::value_error("setPositions expects an (N, 2) array, N being the number of ids");
+  auto const* pos = positions.data();
+  nged::Vector<nged::Vec2> poslist(idlist.size());
+  for (size_t i = 0; i < idlist.size(); ++i)
+    poslist[i] = nged::Vec2{pos[i * 2], pos[i * 2 + 1]};
+  return graph->setPositions(idlist, poslist);
+}
+
+static py::array_t<uint64_t> bulkIdArray(nged::Vector<nged::ItemID> const& ids)
+{
+  py::array_t<uint64_t> result(ids.size());
+  auto* out = result.mutable_data();
+  for (auto id: ids)
+    *out++ = id.value();
+  return result;
+}
+
+// `types` is a sequence of type names, or (codes, names) as returned by `nodeTypes()`;
+// `links` is an (M, 4) integer array of (source node, source pin, dest node, dest pin), nodes are
+// indices into `types`; returns (node ids, link ids), ID_None for whatever failed to add
+static py::tuple bulkAdd(nged::Graph* graph, py::object types, py::object links, py::object positions)
+{
+  nged::Vector<nged::String> typelist;
+  if (py::isinstance<py::tuple>(types) && py::len(types) == 2 && py::isinstance<py::array>(types[py::int_(0)])) {
+    auto codes = types[py::int_(0)].cast<py::array_t<int32_t, py::array::c_style | py::array::forcecast>>();
+    auto names = types[py::int_(1)].cast<std::vector<nged::String>>();
+    typelist.reserve(codes.size());
+    for (auto const *code = codes.data(), *end = code + codes.size(); code != end; ++code) {
+      if (*code < 0 || size_t(*code) >= names.size())
+        throw py::value_error(fmt::format("addBulk: type code {} out of range", *code));
+      typelist.push_back(names[*code]);
+    }
+  } else {
+    for (auto type: types)
+      typelist.push_back(type.cast<nged::String>());
+  }
+
+  nged::Vector<nged::Vec2> poslist;
+  if (!positions.is_none()) {
+    auto arr = positions.cast<py::array_t<float, py::array::c_style | py::array::forcecast>>();
+    if (arr.ndim() != 2 || arr.shape(1) != 2)
+      throw py::value_error("addBulk expects positions as an (N, 2) array");
+    auto const* pos = arr.data();
+    poslist.reserve(arr.shape(0));
+    for (py::ssize_t i = 0; i < arr.shape(0); ++i)
+      poslist.push_back(nged::Vec2{pos[i * 2], pos[i * 2 + 1]});
+  }
+
+  nged::Vector<nged::Graph::BulkLink> linklist;
+  if (!links.is_none()) {
+    auto arr = links.cast<py::array_t<int64_t, py::array::c_style | py::array::forcecast>>();
+    if (arr.size() > 0 && (arr.ndim() != 2 || arr.shape(1) != 4))
+      throw py::value_error("addBulk expects links as an (M, 4) array");
+    auto const* l = arr.data();
+    linklist.reserve(arr.size() / 4);
+    for (py::ssize_t i = 0; i + 3 < arr.size(); i += 4)
+      linklist.push_back({nged::sint(l[i]), nged::sint(l[i + 1]), nged::sint(l[i + 2]), nged::sint(l[i + 3])});
+  }
+
+  nged::Vector<nged::ItemID> nodeIds, linkIds;
+  {
+    // node factories and overrides written in Python take the GIL back when they need it
+    py::gil_scoped_release nogil;
+    graph->addBulk(typelist, poslist, linklist, nodeIds, linkIds);
+  }
+  return py::make_tuple(bulkIdArray(nodeIds), bulkIdArray(linkIds));
+}
+// }}}
+
 // --------------------------------------- PyApp --------------------------------------------------
 // PyApp {{{
 void PyApp::init()
@@ -915,6 +1331,17 @@ PYBIND11_MODULE(ngpy, m) {
     .value("DESELECTED", nged::GraphItemState::DESELECTED);
   // }}}
 
+  // ItemKind {{{
+  py::enum_<nged::ItemKind>(m, "ItemKind")
+    .value("Empty", nged::ItemKind::None) // `None` is reserved in python
+    .value("Node", nged::ItemKind::Node)
+    .value("Link", nged::ItemKind::Link)
+    .value("Router", nged::ItemKind::Router)
+    .value("GroupBox", nged::ItemKind::GroupBox)
+    .value("Resizable", nged::ItemKind::Resizable)
+    .value("Other", nged::ItemKind::Other);
+  // }}}
+
   // ItemID {{{
   py::class_<nged::ItemID>(m, "ItemID")
     .def(py::init([]() { return nged::ID_None; }))
@@ -1103,6 +1530,8 @@ PYBIND11_MODULE(ngpy, m) {
     .def("rename", [](nged::Node* self, nged::String const& name)->py::str {
       nged::String acceptedName = name;
       if (self && self->rename(name, acceptedName)) {
+        if (auto* doc = self->parent() ? self->parent()->docRoot() : nullptr)
+          doc->updateSearchKey(self);
         return py::str(acceptedName);
       }
       return py::none();
@@ -1199,15 +1628,6 @@ PYBIND11_MODULE(ngpy, m) {
   // }}}
 
   // Traverse Result {{{
-  class GraphTraverseResultMadePublic : public nged::GraphTraverseResult
-  {
-  public:
-    auto& inputs() { return inputs_; }
-    auto& outputs() { return inputs_; }
-    auto& nodes() { return inputs_; }
-    auto& closures() { return closures_; }
-    auto& idmap() { return idmap_; }
-  };
   py::class_<nged::GraphTraverseResult::Accessor>(m, "GraphTraverseResultAccesor")
     .def_property_readonly("node", &nged::GraphTraverseResult::Accessor::node)
     .def_property_readonly("inputCount", &nged::GraphTraverseResult::Accessor::inputCount)
@@ -1240,7 +1660,31 @@ PYBIND11_MODULE(ngpy, m) {
     .def("outputOf", &nged::GraphTraverseResult::outputOf, py::arg("nodeIndex"), py::arg("pin"))
     .def("inputIndexOf", &nged::GraphTraverseResult::inputIndexOf, py::arg("nodeIndex"), py::arg("pin"))
     .def("outputIndexOf", &nged::GraphTraverseResult::outputIndexOf, py::arg("nodeIndex"), py::arg("pin"))
-    .def("find", &nged::GraphTraverseResult::find, py::arg("id"));
+    .def("find", &nged::GraphTraverseResult::find, py::arg("id"))
+    // zero-copy, read-only views, valid as long as the result is alive and not traversed again
+    .def_property_readonly("nodeIds", [](py::object self) {
+      auto const& ids = self.cast<nged::GraphTraverseResult const&>().nodeIds();
+      static_assert(sizeof(nged::ItemID) == sizeof(uint64_t), "ItemID should be a plain 64bit value");
+      return bulkReadonlyView<uint64_t>(self, ids.data(), {ids.size()}, {sizeof(nged::ItemID)});
+    }, "uint64 array of node ids")
+    .def_property_readonly("inputIndices", [](py::object self) {
+      auto const& inputs = self.cast<nged::GraphTraverseResult const&>().inputIndices();
+      return bulkReadonlyView<int64_t>(self, inputs.data(), {inputs.size()}, {sizeof(size_t)});
+    }, "int64 CSR column indices of inputs, -1 for unconnected pins")
+    .def_property_readonly("outputIndices", [](py::object self) {
+      auto const& outputs = self.cast<nged::GraphTraverseResult const&>().outputIndices();
+      return bulkReadonlyView<int64_t>(self, outputs.data(), {outputs.size()}, {sizeof(size_t)});
+    }, "int64 CSR column indices of outputs")
+    .def_property_readonly("inputRanges", [](py::object self) {
+      auto const& closures = self.cast<nged::GraphTraverseResult const&>().closures();
+      return bulkReadonlyView<int64_t>(self, closures.empty() ? nullptr : &closures[0].inputs.begin,
+        {closures.size(), size_t(2)}, {sizeof(closures[0]), sizeof(size_t)});
+    }, "(N, 2) int64 array of [begin, end) into inputIndices")
+    .def_property_readonly("outputRanges", [](py::object self) {
+      auto const& closures = self.cast<nged::GraphTraverseResult const&>().closures();
+      return bulkReadonlyView<int64_t>(self, closures.empty() ? nullptr : &closures[0].outputs.begin,
+        {closures.size(), size_t(2)}, {sizeof(closures[0]), sizeof(size_t)});
+    }, "(N, 2) int64 array of [begin, end) into outputIndices");
   // }}}
 
   // Graph {{{
@@ -1300,6 +1744,15 @@ PYBIND11_MODULE(ngpy, m) {
     }, py::arg("item"))
     .def("get", &nged::Graph::get, py::arg("id"))
     .def("tryGet", &nged::Graph::tryGet, py::arg("id"))
+    .def("itemIds", &bulkItemIds, "ids of all items as uint64 array")
+    .def("positions", &bulkPositions, py::arg("ids")=py::none(), "(N, 2) float32 array, NaN for unknown ids")
+    .def("bounds", &bulkBounds, py::arg("ids")=py::none(), "(N, 4) float32 array of (minx, miny, maxx, maxy)")
+    .def("kinds", &bulkKinds, py::arg("ids")=py::none(), "uint8 array of ItemKind")
+    .def("flags", &bulkFlags, py::arg("ids")=py::none(), "uint64 array of node flags, 0 for non-nodes")
+    .def("nodeTypes", &bulkNodeTypes, py::arg("ids")=py::none(), "(int32 codes, type names), -1 for non-nodes")
+    .def("setPositions", &bulkSetPositions, py::arg("ids"), py::arg("positions"), "moves items, returns the number of items moved")
+    .def("addBulk", &bulkAdd, py::arg("types"), py::arg("links")=py::none(), py::arg("positions")=py::none(),
+      "creates and links many nodes in one edit group, returns (node ids, link ids) as uint64 arrays")
     .def("getItemByUID", [](nged::Graph* graph, std::string const& uidstr)->nged::GraphItemPtr{
       if (uidstr.empty())
         return nullptr;
@@ -1347,6 +1800,15 @@ PYBIND11_MODULE(ngpy, m) {
     .def_property_readonly("savePath", &nged::NodeGraphDoc::savePath)
     .def_property_readonly("root", &nged::NodeGraphDoc::root)
     .def_property("readonly", &nged::NodeGraphDoc::readonly, &nged::NodeGraphDoc::setReadonly)
+    .def_property("batchPython",
+      [](nged::NodeGraphDoc const* doc) {
+        auto const* pydoc = dynamic_cast<PyNodeGraphDoc const*>(doc);
+        return pydoc && pydoc->pyBatching();
+      },
+      [](nged::NodeGraphDoc* doc, bool batching) {
+        if (auto* pydoc = dynamic_cast<PyNodeGraphDoc*>(doc))
+          pydoc->setPyBatching(batching);
+      })
     .def("open", &nged::NodeGraphDoc::open, py::arg("path"))
     .def("save", &nged::NodeGraphDoc::save)
     .def("saveAs", &nged::NodeGraphDoc::saveAs, py::arg("path"))
@@ -1646,6 +2108,23 @@ PYBIND11_MODULE(ngpy, m) {
     .def("setAfterPasteCallback", [](nged::EditorPtr editor, pybind11::function callback) {
       static_cast<PyResponser*>(editor->responser())->pyAfterPasteCallback = callback;
     })
+    .def("setResponder", [](nged::EditorPtr editor, pybind11::object responder) {
+      static_cast<PyResponser*>(editor->responser())->setPyResponder(responder);
+    }, py::arg("responder"))
+    .def("responserHookStats", [](nged::EditorPtr editor) {
+      auto* responser = static_cast<PyResponser*>(editor->responser());
+      py::dict result;
+      for (int i = 0; i < static_cast<int>(PyResponser::Hook::Count); ++i) {
+        auto  hook  = static_cast<PyResponser::Hook>(i);
+        auto& stats = responser->hookStats(hook);
+        if (stats.calls != 0)
+          result[PyResponser::hookName(hook)] = py::make_tuple(stats.calls, stats.seconds);
+      }
+      return result;
+    })
+    .def("resetResponserHookStats", [](nged::EditorPtr editor) {
+      static_cast<PyResponser*>(editor->responser())->resetHookStats();
+    })
     .def("setParmModifiedCallback", [](PyImGuiNodeGraphEditor* editor, pybind11::function callback) {
       editor->pyParmModifiedCallback = callback;
     });
@@ -1670,6 +2149,9 @@ PYBIND11_MODULE(ngpy, m) {
     .def("fatal", &msghub::fatal);
 
   m.def("startApp", &nged::startApp);
+  m.def("requestRedraw", &nged::requestRedraw, py::arg("frames") = 1);
+  m.def("setOnDemandRedraw", &nged::setOnDemandRedraw);
+  m.def("onDemandRedraw", &nged::onDemandRedraw);
   // }}}
 
   // ImGui {{{
@@ -1,7 +1,10 @@
 #include <doctest/doctest.h>
 #include <nged/nged.h>
 
+#include <chrono>
 #include <ostream>
+#include <set>
+#include <thread>
 
 namespace gmath {
 std::ostream& operator<<(std::ostream& os, nged::Color const& c)
@@ -66,6 +69,8 @@ class MyNodeFactory: public nged::NodeFactory
     std::string typestr(type);
     if (type=="subgraph")
       return std::make_shared<SubGraphNode>(parent);
+    if (type=="throw")
+      throw std::runtime_error("refused to create node");
     for (auto const& d: defs)
       if (d.type == type)
         return std::make_shared<DummyNode>(d.numinput, d.numoutput, parent, typestr, typestr);
@@ -106,8 +111,14 @@ TEST_CASE("Graph Creation") {
   auto subgraphnode = graph->createNode("subgraph");
   auto* subgraph = subgraphnode->asGraph();
   CHECK(subgraph != nullptr);
-  subgraph->createNode("null");
+  auto subnull = subgraph->createNode("null");
   CHECK(doc.numItems() == 5); // null, exec, link, subgraph, null
+  CHECK(graph->getRaw(id) == graph->get(id).get());
+  CHECK(graph->tryGetRaw(subnull->id()) == nullptr); // not in this graph
+  CHECK(subgraph->tryGetRaw(subnull->id()) == subnull.get());
+  size_t numLinks = 0;
+  graph->forEachLinkRaw([&numLinks](nged::Link* link) { numLinks += link->asLink() != nullptr; });
+  CHECK(numLinks == 1);
 
   SUBCASE("Graph Traverse") {
     auto exec = subgraph->createNode("exec");
@@ -127,9 +138,176 @@ TEST_CASE("Graph Creation") {
 
   graph->remove({subgraphnode->id()});
   subgraphnode.reset();
+  subnull.reset();
   CHECK(doc.numItems() == 3); // subgraph and its content should be gone.
 }
 
+TEST_CASE("History Undo Redo") {
+  auto itemfactory = nged::defaultGraphItemFactory();
+  nged::NodeGraphDoc doc(std::make_shared<MyNodeFactory>(), itemfactory.get());
+  doc.makeRoot();
+  auto graph = doc.root();
+  doc.history().reset(true);
+  auto a = graph->createNode("null");
+  auto b = graph->createNode("exec");
+  graph->setLink(a->id(), 0, b->id(), 0);
+  doc.history().commit("add nodes");
+  CHECK(doc.numItems() == 3);
+  CHECK(doc.history().numCommits() == 2);
+  CHECK(!doc.binarySerialization());
+
+  CHECK(doc.history().undo());
+  CHECK(doc.numItems() == 0);
+  CHECK(doc.history().redo());
+  CHECK(doc.numItems() == 3);
+  CHECK(!doc.binarySerialization());
+}
+
+TEST_CASE("Bulk Add") {
+  auto itemfactory = nged::defaultGraphItemFactory();
+  nged::NodeGraphDoc doc(std::make_shared<MyNodeFactory>(), itemfactory.get());
+  doc.makeRoot();
+  auto graph = doc.root();
+  doc.history().reset(true);
+  int notified = 0;
+  doc.setModifiedNotifier([&notified](nged::Graph*) { ++notified; });
+
+  nged::Vector<nged::ItemID> nodeIds, linkIds;
+  CHECK(graph->addBulk(
+    {"in", "in", "merge", "out"},
+    {{0, 0}, {100, 0}},
+    {{0, 0, 2, -1}, {1, 0, 2, -1}, {2, 0, 3, 0}, {0, 0, 9, 0}},
+    nodeIds,
+    linkIds));
+  CHECK(notified == 1);
+  CHECK(doc.history().numCommits() == 2);
+  REQUIRE(nodeIds.size() == 4);
+  REQUIRE(linkIds.size() == 4);
+  CHECK(linkIds[3] == nged::ID_None);
+  CHECK(doc.numItems() == 7);
+  CHECK(graph->get(nodeIds[1])->pos() == nged::Vec2{100, 0});
+
+  nged::InputConnection ic;
+  CHECK(graph->getLinkSource(nodeIds[2], 1, ic));
+  CHECK(ic.sourceItem == nodeIds[1]);
+  CHECK(graph->getLinkSource(nodeIds[3], 0, ic));
+  CHECK(ic.sourceItem == nodeIds[2]);
+
+  // a throwing factory fails that node only
+  CHECK(graph->addBulk({"in", "throw", "out"}, {}, {{0, 0, 2, 0}, {1, 0, 2, 0}}, nodeIds, linkIds));
+  REQUIRE(nodeIds.size() == 3);
+  CHECK(nodeIds[0] != nged::ID_None);
+  CHECK(nodeIds[1] == nged::ID_None);
+  CHECK(nodeIds[2] != nged::ID_None);
+  CHECK(linkIds[0] != nged::ID_None);
+  CHECK(linkIds[1] == nged::ID_None);
+}
+
+TEST_CASE("Bulk Set Positions") {
+  auto itemfactory = nged::defaultGraphItemFactory();
+  nged::NodeGraphDoc doc(std::make_shared<MyNodeFactory>(), itemfactory.get());
+  doc.makeRoot();
+  auto graph = doc.root();
+  auto a = graph->createNode("in");
+  auto b = graph->createNode("out");
+  auto link = graph->setLink(a->id(), 0, b->id(), 0);
+  REQUIRE(link);
+  auto const other = doc.root()->createNode("null");
+  graph->remove({other->id()}); // stale id, skipped
+  doc.history().reset(true);
+  int notified = 0;
+  doc.setModifiedNotifier([&notified](nged::Graph*) { ++notified; });
+
+  CHECK(graph->setPositions({a->id(), b->id(), other->id()}, {{0, 0}, {0, 300}, {9, 9}}) == 2);
+  CHECK(notified == 1);
+  CHECK(doc.history().numCommits() == 2);
+  CHECK(a->pos() == nged::Vec2{0, 0});
+  CHECK(b->pos() == nged::Vec2{0, 300});
+  CHECK(doc.pool().hotFields().pos[b->id().index()] == b->pos());
+  CHECK(link->aabb().max.y > 250); // path follows the nodes
+
+  doc.setReadonly(true);
+  CHECK(graph->setPositions({a->id()}, {{100, 100}}) == 0);
+  CHECK(a->pos() == nged::Vec2{0, 0});
+}
+
+TEST_CASE("Item Pool Hot Fields") {
+  auto itemfactory = nged::defaultGraphItemFactory();
+  nged::NodeGraphDoc doc(std::make_shared<MyNodeFactory>(), itemfactory.get());
+  doc.makeRoot();
+  auto graph = doc.root();
+  auto a = graph->createNode("null");
+  auto b = graph->createNode("null");
+  a->moveTo({0, 0});
+  b->moveTo({1000, 0});
+
+  auto const& hot = doc.pool().hotFields();
+  auto const ia = a->id().index();
+  CHECK(hot.id[ia] == a->id());
+  CHECK(hot.item[ia] == a.get());
+  CHECK(hot.parent[ia] == graph.get());
+  CHECK(hot.kind[ia] == nged::ItemKind::Node);
+  CHECK(hot.pos[ia] == a->pos());
+  CHECK(hot.bounds[ia].center() == a->aabb().center());
+
+  nged::Vector<nged::GraphItem*> found;
+  graph->itemsInBound(nged::AABB({-10, -10}, {10, 10}), found);
+  CHECK(found.size() == 1);
+  CHECK(found[0] == a.get());
+
+  a->asNode()->resize(500, 20);
+  CHECK(hot.bounds[ia].width() == doctest::Approx(500));
+  CHECK(graph->itemsBound().max.x == doctest::Approx(b->aabb().max.x));
+
+  graph->remove({a->id()});
+  CHECK(hot.id[ia] == nged::ID_None);
+  CHECK(hot.kind[ia] == nged::ItemKind::None);
+  found.clear();
+  graph->itemsInBound(nged::AABB({-10, -10}, {10, 10}), found);
+  CHECK(found.empty());
+
+  // items of other graphs are not reported
+  auto subgraphnode = graph->createNode("subgraph");
+  subgraphnode->moveTo({0, -1000});
+  auto subgraph = subgraphnode->asGraph();
+  subgraph->createNode("null")->moveTo({0, 0});
+  found.clear();
+  graph->itemsInBound(nged::AABB({-10, -10}, {10, 10}), found);
+  CHECK(found.empty());
+  subgraph->itemsInBound(nged::AABB({-10, -10}, {10, 10}), found);
+  CHECK(found.size() == 1);
+
+  // comment bounds follow the text before it is ever drawn
+  auto comment = std::make_shared<nged::CommentBox>(graph.get());
+  graph->add(comment);
+  comment->moveTo({0, 500});
+  auto const ic = comment->id().index();
+  auto const shortWidth = hot.bounds[ic].width();
+  comment->setText(std::string(200, 'x'));
+  CHECK(hot.bounds[ic].width() > shortWidth);
+  CHECK(hot.bounds[ic].width() == doctest::Approx(comment->aabb().width()));
+  found.clear();
+  graph->itemsInBound(nged::AABB({1000, 490}, {1010, 510}), found);
+  CHECK(std::find(found.begin(), found.end(), comment.get()) != found.end());
+
+  // an item that grows without syncing is picked up again by the next commit
+  struct GrowingItem : public nged::GraphItem
+  {
+    using GraphItem::GraphItem;
+    void grow(float r) { aabb_ = nged::AABB({-r, -r}, {r, r}); }
+  };
+  auto growing = std::make_shared<GrowingItem>(graph.get());
+  graph->add(growing);
+  growing->moveTo({0, 2000});
+  growing->grow(50);
+  CHECK(hot.bounds[growing->id().index()].width() == doctest::Approx(0));
+  doc.history().commit("grow");
+  CHECK(hot.bounds[growing->id().index()].width() == doctest::Approx(100));
+  found.clear();
+  graph->itemsInBound(nged::AABB({40, 1960}, {45, 1965}), found);
+  CHECK(std::find(found.begin(), found.end(), growing.get()) != found.end());
+}
+
 struct DummyTypedDef
 {
   nged::String type;
@@ -189,6 +367,130 @@ class MyTypedNodeFactory: public nged::NodeFactory
   }
 };
 
+TEST_CASE("Node Search Index") {
+  auto itemfactory = nged::defaultGraphItemFactory();
+  nged::NodeGraphDoc doc(std::make_shared<MyNodeFactory>(), itemfactory.get());
+  doc.makeRoot();
+  auto graph = doc.root();
+  auto subnode = graph->createNode("subgraph");
+  REQUIRE(subnode);
+  auto merge = graph->createNode("merge");
+  auto split = subnode->asGraph()->createNode("split");
+  auto inner = subnode->asGraph()->createNode("exec");
+  CHECK(doc.searchIndex().size() == 4);
+
+  auto found = [&doc](std::string_view pattern, bool subsequence) {
+    nged::Vector<nged::NodeSearchIndex::Entry> entries;
+    doc.searchIndex().candidates(pattern, subsequence, entries);
+    std::set<nged::ItemID> ids;
+    for (auto const& e : entries)
+      ids.insert(e.id);
+    return ids;
+  };
+  CHECK(found("SPL", false) == std::set<nged::ItemID>{split->id()});
+  CHECK(found("plit", false) == std::set<nged::ItemID>{split->id()});
+  CHECK(found("xyz", false).empty());
+  CHECK(found("mg", true).count(merge->id()) == 1);
+  CHECK(found("mg", true).count(split->id()) == 0);
+
+  // the snapshot searches run on is shared until the index changes, and stays as it was after
+  auto before = doc.searchIndex().snapshot();
+  CHECK(before == doc.searchIndex().snapshot());
+  CHECK(before->size() == 4);
+  nged::Vector<uint32_t> slots;
+  CHECK(!doc.searchIndex().narrow("mg", true, slots));
+  CHECK(doc.searchIndex().narrow("spl", false, slots));
+  REQUIRE(slots.size() == 1);
+  CHECK((*before)[slots[0]].id == split->id());
+
+  nged::String accepted;
+  CHECK(inner->rename("splitter", accepted));
+  doc.updateSearchKey(inner.get());
+  CHECK(before != doc.searchIndex().snapshot());
+  CHECK(before->size() == 4);
+  CHECK(found("split", false) == std::set<nged::ItemID>{split->id(), inner->id()});
+  CHECK(found("exe", false).empty());
+
+  subnode->asGraph()->remove({split->id()});
+  CHECK(found("split", false) == std::set<nged::ItemID>{inner->id()});
+  CHECK(doc.searchIndex().size() == 3);
+
+  // keys changed behind the index's back are picked up on commit
+  CHECK(merge->rename("joiner", accepted));
+  CHECK(found("join", false).empty());
+  doc.history().commit("rename");
+  CHECK(found("join", false) == std::set<nged::ItemID>{merge->id()});
+}
+
+TEST_CASE("MessageHub Producers") {
+  using MessageHub = nged::MessageHub;
+  using msghub     = nged::MessageHub;
+  auto& hub = MessageHub::instance();
+  hub.clear(MessageHub::Category::Output);
+  hub.setCountLimit(20000);
+
+  std::vector<std::thread> producers;
+  for (int t = 0; t < 4; ++t)
+    producers.emplace_back([t] {
+      for (int i = 0; i < 3000; ++i)
+        msghub::outputf("{}:{}", t, i);
+    });
+  size_t seen     = 0;
+  auto   deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (seen < 12000 && std::chrono::steady_clock::now() < deadline) // read while they write, like the message view does
+    seen = hub.count(MessageHub::Category::Output);
+  for (auto& p : producers)
+    p.join();
+  CHECK(hub.count(MessageHub::Category::Output) == 12000);
+
+  int last[4] = {-1, -1, -1, -1};
+  bool ordered = true;
+  hub.foreach(MessageHub::Category::Output, [&](MessageHub::Message const& msg) {
+    int t = std::stoi(msg.content.substr(0, 1)), i = std::stoi(msg.content.substr(2));
+    ordered = ordered && i == last[t] + 1;
+    last[t] = i;
+  });
+  CHECK(ordered);
+
+  // a reader holding the view must not stall producers, even when their ring fills up
+  auto produced = std::make_shared<std::atomic<bool>>(false);
+  hub.view(MessageHub::Category::Output, [&](auto const&, size_t) {
+    std::thread producer([produced] {
+      for (int i = 0; i < 3000; ++i)
+        msghub::output("while viewing");
+      *produced = true;
+    });
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!*produced && std::chrono::steady_clock::now() < deadline)
+      std::this_thread::yield();
+    CHECK(*produced);
+    if (*produced)
+      producer.join();
+    else
+      producer.detach(); // it finishes once the view returns
+  });
+  CHECK(hub.count(MessageHub::Category::Output) == 15000);
+
+  auto logs      = hub.count(MessageHub::Category::Log);
+  auto verbosity = hub.minVerbosity();
+  static std::atomic<int> notified = 0; // what the editor's redraw request would see
+  hub.setNotifier([] { ++notified; });
+  hub.setMinVerbosity(MessageHub::Verbosity::Info);
+  msghub::trace("filtered");
+  msghub::debugf("filtered {}", 42);
+  CHECK(hub.count(MessageHub::Category::Log) == logs);
+  CHECK(notified == 0);
+  msghub::info("kept");
+  CHECK(hub.count(MessageHub::Category::Log) == logs + 1);
+  CHECK(notified == 1);
+  hub.setNotifier(nullptr);
+  hub.setMinVerbosity(verbosity);
+
+  hub.setCountLimit(4096);
+  CHECK(hub.count(MessageHub::Category::Output) == 4096);
+  hub.clear(MessageHub::Category::Output);
+}
+
 TEST_CASE("TypedNode Test") {
   SUBCASE("TypeSystem Test") {
     auto& typesys = nged::TypeSystem::instance();
@@ -218,6 +520,15 @@ TEST_CASE("TypedNode Test") {
 
     CHECK(typesys.isConvertable("int", "any"));
     CHECK(!typesys.isConvertable("any", "int"));
+
+    // transitive: int -> float -> vec2, unless denied explicitly
+    CHECK(typesys.isConvertable("int", "vec2"));
+    typesys.setConvertable("int", "vec4", false);
+    CHECK(!typesys.isConvertable("int", "vec4"));
+    typesys.registerType("mat3x", "mat3");
+    CHECK(typesys.isConvertable(typesys.typeIndex("mat3x"), typesys.typeIndex("mat3")));
+    CHECK(!typesys.isConvertable(typesys.typeIndex("mat3"), typesys.typeIndex("mat3x")));
+    CHECK(!typesys.isConvertable(typesys.typeIndex("int"), nged::TypeSystem::InvalidTypeIndex));
   }
 
   auto itemfactory = nged::defaultGraphItemFactory();
@@ -243,6 +554,50 @@ TEST_CASE("TypedNode Test") {
   CHECK(sumint->getPinForIncomingLink(makefloat->id(), 0) == -1);
   CHECK(sumfloat->getPinForIncomingLink(makeint->id(), 0) == 0);
 
+  CHECK(&sumint->asTypedNode()->pinSignature() == &graph->createNode("sumint")->asTypedNode()->pinSignature());
+  CHECK(sumfloat->asTypedNode()->inputType(1) == "float");
+  CHECK(sumfloat->asTypedNode()->inputType(2) == "");
+
   CHECK(sumint->outputPinColor(0) == nged::Color{255,255,0,255});
   CHECK(sumint->inputPinColor(0) == nged::Color{255,255,0,255});
 }
+
+TEST_CASE("Item Access Benchmark" * doctest::skip()) {
+  auto itemfactory = nged::defaultGraphItemFactory();
+  nged::NodeGraphDoc doc(std::make_shared<MyNodeFactory>(), itemfactory.get());
+  doc.makeRoot();
+  auto graph = doc.root();
+  nged::ItemID prev = nged::ID_None;
+  for (int i = 0; i < 20000; ++i) {
+    auto node = graph->createNode("null");
+    node->moveTo({float(i % 100) * 80.f, float(i / 100) * 40.f});
+    if (prev != nged::ID_None)
+      graph->setLink(prev, 0, node->id(), 0);
+    prev = node->id();
+  }
+
+  auto bestOf = [](int runs, auto&& func) {
+    double best = 1e30;
+    for (int i = 0; i < runs; ++i) {
+      auto start = std::chrono::high_resolution_clock::now();
+      func();
+      std::chrono::duration<double, std::micro> dt = std::chrono::high_resolution_clock::now() - start;
+      best = std::min(best, dt.count());
+    }
+    return best;
+  };
+  float sumShared = 0, sumRaw = 0;
+  auto shared = bestOf(20, [&] {
+    sumShared = 0;
+    graph->forEachItem([&](nged::GraphItemPtr item) { sumShared += item->pos().x; });
+    graph->forEachLink([&](nged::LinkPtr link) { sumShared += link->path().size(); });
+  });
+  auto raw = bestOf(20, [&] {
+    sumRaw = 0;
+    graph->forEachItemRaw([&](nged::GraphItem* item) { sumRaw += item->pos().x; });
+    graph->forEachLinkRaw([&](nged::Link* link) { sumRaw += link->path().size(); });
+  });
+  MESSAGE("forEachItem + forEachLink: " << shared << "us, raw: " << raw << "us, "
+                                        << doc.numItems() << " items");
+  CHECK(sumShared == sumRaw);
+}
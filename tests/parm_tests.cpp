@@ -0,0 +1,306 @@
+#include <doctest/doctest.h>
+#include <binparm.h>
+#include <jsonparm.h>
+#include <nlohmann/json.hpp>
+#include <parminspector.h>
+#include <parmscript.h>
+
+#include <string>
+#include <vector>
+
+using parmscript::Parm;
+using parmscript::ParmHandle;
+using parmscript::ParmSet;
+using parmscript::ParmSetInspector;
+
+static char const* const benchScript = R"(
+toggle "enabled" {default=true}
+int "count" {default=3, min=0, max=10}
+float "scale" {default=0.5, disablewhen="{count} > 5"}
+float3 "offset" {default={1,2,3}}
+text "name" {default="hello", font="mono"}
+menu "mode" {items={"add", "sub", "mul"}, default="sub"}
+struct "transform"
+  float2 "translate" {default={0,0}}
+  float "rotate" {min=-180, max=180}
+endstruct "transform"
+list "points" {default=2}
+  text "tag"
+  int2 "xy"
+endlist "points"
+)";
+
+TEST_CASE("Parm Handle") {
+  ParmSet ps;
+  ps.loadScript(benchScript);
+  REQUIRE(ps.loaded());
+
+  auto count  = ps.handle("count");
+  auto rotate = ps.handle("transform.rotate");
+  REQUIRE(count);
+  REQUIRE(rotate);
+  CHECK(count.id() == ps.get("count")->id());
+  CHECK(count.ptr() == ps.get("count"));
+  CHECK(rotate.get() == ps.get("transform.rotate").get());
+  CHECK(ps.handle("")->ui() == Parm::ui_type_enum::STRUCT);
+  CHECK_FALSE(ps.handle("nothing"));
+  CHECK_FALSE(ps.handle("transform.nothing"));
+  CHECK_FALSE(ps.handle("points[0].tag")); // list items share the id of their template
+  CHECK_FALSE(ParmHandle());
+
+  // ids are the same for every instance of a script
+  ParmSet other;
+  other.loadScript(benchScript);
+  CHECK(other.handle("transform.rotate").id() == rotate.id());
+  CHECK(other.parmById(rotate.id()) == other.get("transform.rotate"));
+
+  SUBCASE("typed accessors") {
+    CHECK(count.as<int>() == 3);
+    CHECK(ps.handle("enabled").as<bool>() == true);
+    CHECK(ps.handle("name").as<std::string>() == "hello");
+    CHECK(ps.handle("offset").as<Parm::float3>().z == doctest::Approx(3));
+    CHECK(count.set(7));
+    CHECK(ps.get("count")->as<int>() == 7);
+    CHECK_FALSE(count.set(std::string("seven"))); // type mismatch, untouched
+    CHECK(count.as<int>() == 7);
+    CHECK(rotate.set(90.f));
+    CHECK(ps.get("transform")->getField("rotate")->as<float>() == doctest::Approx(90));
+
+    auto mode = ps.handle("mode");
+    CHECK(mode.as<std::string>() == "sub");
+    CHECK(mode.set(2));
+    CHECK(mode.as<std::string>() == "mul");
+  }
+
+  SUBCASE("dirty bits") {
+    auto scale     = ps.handle("scale");
+    auto transform = ps.handle("transform");
+    CHECK(ps.dirtyParmIds().empty());
+    CHECK_FALSE(count.dirty());
+
+    count.set(4);
+    CHECK(count.dirty());
+    CHECK(scale.dirty());            // disablewhen reads {count}
+    CHECK(ps.handle("").dirty());    // the root contains it
+    CHECK_FALSE(transform.dirty());
+    CHECK_FALSE(rotate.dirty());
+    CHECK(ps.isDirty(count.id()));
+    CHECK(ps.dirtyBits()[count.id()]);
+    CHECK(ps.dirtyEntries().count("count") == 1);
+    CHECK(ps.dirtyEntries().count("scale") == 0); // only modified parms have entries
+
+    auto const numDirty = ps.dirtyParmIds().size();
+    count.set(5); // already dirty, nothing new
+    CHECK(ps.dirtyParmIds().size() == numDirty);
+
+    rotate.set(1.f);
+    CHECK(transform.dirty());
+    CHECK(ps.dirtyEntries().count("transform.rotate") == 1);
+
+    auto points = ps.handle("points");
+    points->resizeList(2);
+    CHECK(points.dirty());
+    CHECK(points->setListValue(1, 0, std::string("b")));
+    CHECK(ps.dirtyEntries().count("points[1].tag") == 1);
+
+    ps.clearDirtyEntries();
+    CHECK(ps.dirtyParmIds().empty());
+    CHECK(ps.dirtyEntries().empty());
+    CHECK_FALSE(count.dirty());
+    CHECK_FALSE(transform.dirty());
+    CHECK(other.dirtyParmIds().empty());
+  }
+}
+
+TEST_CASE("Parm Inspector Lookup") {
+  ParmSetInspector inspector;
+  CHECK(inspector.getParm("count") == nullptr);
+  inspector.loadParmScript(benchScript);
+  auto count = inspector.getParm("count");
+  REQUIRE(count);
+  CHECK(count == inspector.parms().get("count"));
+  CHECK(inspector.getParm("count") == count);
+  inspector.parms().get("points")->resizeList(2);
+  REQUIRE(inspector.getParm("points[1].xy"));
+  CHECK(inspector.getParm("points[1].xy") == inspector.parms().get("points[1].xy"));
+  CHECK(inspector.getParm("nothing") == nullptr);
+
+  // reloading drops the handles resolved against the old parms
+  inspector.loadParmScript(R"(float "count" {default=2})");
+  REQUIRE(inspector.getParm("count"));
+  CHECK(inspector.getParm("count") != count);
+  CHECK(inspector.getParm("count")->as<float>() == doctest::Approx(2));
+  CHECK(inspector.getParm("scale") == nullptr);
+}
+
+// sets a value on every kind of parm in benchScript, away from its default
+static void editParms(ParmSet& ps)
+{
+  ps.get("enabled")->set(false);
+  ps.get("count")->set(9);
+  ps.get("scale")->set(0.25f);
+  ps.get("offset")->set(Parm::float3{-1, 0.5f, 8});
+  ps.get("name")->set(std::string("world"));
+  ps.get("mode")->set(2);
+  ps.get("transform.translate")->set(Parm::float2{3, 4});
+  ps.get("transform.rotate")->set(-45.f);
+  auto points = ps.get("points");
+  points->resizeList(3);
+  points->setListValue(0, 0, std::string("a"));
+  points->setListValue(2, 0, std::string("c"));
+  points->setListValue(2, 1, Parm::int2{5, -6});
+}
+
+static void checkEdited(ParmSet& ps)
+{
+  CHECK(ps.get("enabled")->as<bool>() == false);
+  CHECK(ps.get("count")->as<int>() == 9);
+  CHECK(ps.get("scale")->as<float>() == doctest::Approx(0.25));
+  CHECK(ps.get("offset")->as<Parm::float3>().x == doctest::Approx(-1));
+  CHECK(ps.get("offset")->as<Parm::float3>().y == doctest::Approx(0.5));
+  CHECK(ps.get("offset")->as<Parm::float3>().z == doctest::Approx(8));
+  CHECK(ps.get("name")->as<std::string>() == "world");
+  CHECK(ps.get("mode")->as<int>() == 2);
+  CHECK(ps.get("transform.translate")->as<Parm::float2>().y == doctest::Approx(4));
+  CHECK(ps.get("transform.rotate")->as<float>() == doctest::Approx(-45));
+  REQUIRE(ps.get("points")->numListValues() == 3);
+  CHECK(ps.get("points[0].tag")->as<std::string>() == "a");
+  CHECK(ps.get("points[1].tag")->as<std::string>() == "");
+  CHECK(ps.get("points[2].tag")->as<std::string>() == "c");
+  CHECK(ps.get("points[2].xy")->as<Parm::int2>().y == -6);
+}
+
+TEST_CASE("Parm Binary Serialization") {
+  ParmSet src;
+  src.loadScript(benchScript);
+  editParms(src);
+  std::vector<uint8_t> blob;
+  to_binary(blob, src);
+  REQUIRE(blob.size() > 3);
+
+  SUBCASE("round trip") {
+    ParmSet dst;
+    dst.loadScript(benchScript);
+    CHECK(dst.get("count")->as<int>() == 3);
+    CHECK(from_binary(blob, dst));
+    checkEdited(dst);
+
+    // reading back into edited parms replaces every value, lists shrink too
+    dst.get("points")->resizeList(5);
+    dst.get("name")->set(std::string("changed"));
+    CHECK(from_binary(blob, dst));
+    checkEdited(dst);
+
+    std::vector<uint8_t> again;
+    to_binary(again, dst);
+    CHECK(again == blob);
+  }
+
+  SUBCASE("single parm") {
+    std::vector<uint8_t> structBlob;
+    to_binary(structBlob, *src.get("transform"));
+    ParmSet dst;
+    dst.loadScript(benchScript);
+    CHECK(from_binary(structBlob.data(), structBlob.size(), *dst.get("transform")));
+    CHECK(dst.get("transform.rotate")->as<float>() == doctest::Approx(-45));
+    CHECK(dst.get("count")->as<int>() == 3);
+    // a struct does not fit a field, fields of another struct are matched by name
+    CHECK_FALSE(from_binary(structBlob.data(), structBlob.size(), *dst.get("count")));
+    CHECK(dst.get("count")->as<int>() == 3);
+    dst.get("transform.rotate")->set(0.f);
+    CHECK(from_binary(structBlob.data(), structBlob.size(), *dst.get("")));
+    CHECK(dst.get("transform.rotate")->as<float>() == doctest::Approx(0));
+  }
+
+  SUBCASE("template mismatch") {
+    // an undo snapshot taken before the node's script was edited:
+    // fields are matched by name, retyped and unknown ones keep their values
+    ParmSet edited;
+    edited.loadScript(R"(
+float "count" {default=1}
+text "name"
+int "added" {default=7}
+struct "transform"
+  float "rotate"
+  float "scale" {default=1}
+endstruct "transform"
+toggle "enabled" {default=true}
+list "points"
+  text "tag"
+endlist "points"
+)");
+    CHECK(from_binary(blob, edited));
+    CHECK(edited.get("count")->as<float>() == doctest::Approx(1));
+    CHECK(edited.get("name")->as<std::string>() == "world");
+    CHECK(edited.get("added")->as<int>() == 7);
+    CHECK(edited.get("transform.rotate")->as<float>() == doctest::Approx(-45));
+    CHECK(edited.get("transform.scale")->as<float>() == doctest::Approx(1));
+    CHECK(edited.get("enabled")->as<bool>() == false);
+    REQUIRE(edited.get("points")->numListValues() == 3);
+    CHECK(edited.get("points[2].tag")->as<std::string>() == "c");
+
+    ParmSet fewer;
+    fewer.loadScript(R"(toggle "enabled" {default=true})");
+    CHECK(from_binary(blob, fewer));
+    CHECK(fewer.get("enabled")->as<bool>() == false);
+
+    ParmSet empty;
+    CHECK_FALSE(from_binary(blob, empty));
+  }
+
+  SUBCASE("corrupted blobs") {
+    ParmSet dst;
+    dst.loadScript(benchScript);
+    CHECK_FALSE(from_binary(std::vector<uint8_t>{}, dst));
+    auto badMagic = blob;
+    badMagic[0]   = 'X';
+    CHECK_FALSE(from_binary(badMagic, dst));
+    auto badVersion = blob;
+    badVersion[2]   = 0xff;
+    CHECK_FALSE(from_binary(badVersion, dst));
+    for (size_t size : {size_t(3), blob.size() / 2, blob.size() - 1})
+      CHECK_FALSE(from_binary(std::vector<uint8_t>(blob.begin(), blob.begin() + size), dst));
+    auto trailing = blob;
+    trailing.push_back(0);
+    CHECK_FALSE(from_binary(trailing, dst));
+    // nothing was written by the rejected blobs, not even the fields before the damage
+    CHECK(dst.get("enabled")->as<bool>() == true);
+    CHECK(dst.get("count")->as<int>() == 3);
+    CHECK(dst.get("name")->as<std::string>() == "hello");
+    CHECK(dst.get("points")->numListValues() == 0);
+  }
+
+  SUBCASE("json fallback") {
+    // the same dispatch PyNode::deserialize does on its "parms" entry:
+    // history snapshots embed the blob as cbor binary, text files store plain json
+    auto load = [](nlohmann::json const& parms, ParmSet& dst) {
+      if (!parms.is_binary()) {
+        from_json(parms, dst);
+        return true;
+      }
+      return from_binary(parms.get_binary(), dst);
+    };
+
+    nlohmann::json snapshot;
+    snapshot["parms"] = nlohmann::json::binary(std::vector<uint8_t>(blob));
+    auto restored     = nlohmann::json::from_cbor(nlohmann::json::to_cbor(snapshot));
+    REQUIRE(restored["parms"].is_binary());
+    ParmSet fromBinary;
+    fromBinary.loadScript(benchScript);
+    CHECK(load(restored["parms"], fromBinary));
+    checkEdited(fromBinary);
+
+    nlohmann::json file;
+    to_json(file["parms"], src);
+    auto reread = nlohmann::json::parse(file.dump());
+    REQUIRE_FALSE(reread["parms"].is_binary());
+    ParmSet fromText;
+    fromText.loadScript(benchScript);
+    CHECK(load(reread["parms"], fromText));
+    checkEdited(fromText);
+
+    std::vector<uint8_t> textBlob;
+    to_binary(textBlob, fromText);
+    CHECK(textBlob == blob);
+  }
+}
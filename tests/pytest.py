@@ -72,6 +72,103 @@ tr = doc.root.traverse([zz.id])
 for i in range(len(tr)):
     print(f'{i}: {tr[i]}')
 
+print('----bulk api----')
+ids = doc.root.itemIds()
+print(f'itemIds = {ids}')
+assert len(ids) == len(doc.root.items())
+assert doc.root.setPositions([yy.id, zz.id], [[0, 0], [0, 200]]) == 2
+pos = doc.root.positions([yy.id, zz.id])
+assert pos.shape == (2, 2) and pos[1][1] == 200
+bounds = doc.root.bounds([zz.id])
+assert bounds[0][1] < 200 < bounds[0][3]
+codes, names = doc.root.nodeTypes([yy.id, zz.id, link.id])
+assert names[codes[0]] == 'dummy' and codes[0] == codes[1] and codes[2] == -1
+assert doc.root.flags([yy.id]).shape == (1,)
+assert doc.root.kinds([yy.id, link.id])[0] != doc.root.kinds([yy.id, link.id])[1]
+nodeIds, linkIds = doc.root.addBulk(['dummy', 'dummy'], [(0, 0, 1, 0)], [(0, 400), (0, 600)])
+assert len(nodeIds) == 2 and len(linkIds) == 1
+assert doc.root.positions(nodeIds)[1][1] == 600
+
+print('----deferred deserialization----')
+class StatefulNode(Node):
+    log = []
+
+    def __init__(self, parent, definition):
+        Node.__init__(self, parent, definition)
+        self.state = 0
+
+    def serialize(self):
+        return str(self.state)
+
+    def deserialize(self, data):
+        # deferred till the whole graph, links included, is restored
+        StatefulNode.log.append((data, len(self.graph.links())))
+        self.state = int(data)
+
+nodeFactory.register(NodeDef({'type': 'stateful', 'label': 'Stateful', 'numMaxInputs': 1, 'numOutputs': 1}), StatefulNode)
+
+import os, tempfile
+statefulDoc = Document(nodeFactory, itemFactory)
+aa = statefulDoc.root.createNode('stateful')
+bb = statefulDoc.root.createNode('stateful')
+aa.state, bb.state = 1, 2
+statefulDoc.root.setLink(aa.id, 0, bb.id, 0)
+path = os.path.join(tempfile.mkdtemp(), 'stateful.json')
+assert statefulDoc.saveTo(path)
+assert statefulDoc.open(path)
+print(f'deserialize calls = {StatefulNode.log}')
+assert sorted(StatefulNode.log) == [('1', 1), ('2', 1)]
+
+aa = bb = statefulDoc = None
+
+print('----batched (de)serialization latency----')
+# python (de)serialization of a document is batched under one GIL acquisition,
+# `batchPython = False` takes the per-item path for comparison
+import json, time
+bigDoc = Document(nodeFactory, itemFactory)
+bigIds, _ = bigDoc.root.addBulk(['stateful'] * 10000, [], [(i % 100 * 150, i // 100 * 100) for i in range(10000)])
+for i, nodeId in enumerate(bigIds):
+    bigDoc.root.get(nodeId).state = i
+
+def bestOf(runs, func):
+    best = float('inf')
+    for _ in range(runs):
+        start = time.perf_counter()
+        func()
+        best = min(best, time.perf_counter() - start)
+    return best * 1000
+
+def pyStates(node):
+    # the python state of every node in a saved document
+    if isinstance(node, dict):
+        if 'pynode' in node:
+            yield node['pynode']
+        for value in node.values():
+            yield from pyStates(value)
+    elif isinstance(node, list):
+        for value in node:
+            yield from pyStates(value)
+
+def commit():
+    bigDoc.beginEditGroup()
+    bigDoc.endEditGroup('bench')
+
+timings = {}
+for batched in (False, True):
+    bigDoc.batchPython = batched
+    bigPath = os.path.join(tempfile.mkdtemp(), 'big.json')
+    timings[batched] = (
+        bestOf(3, commit),
+        bestOf(3, lambda: bigDoc.saveTo(bigPath)),
+        bestOf(3, lambda: bigDoc.open(bigPath)))
+    with open(bigPath) as f:
+        timings[batched] += (sorted(pyStates(json.load(f))),)
+assert bigDoc.batchPython
+assert timings[False][3] == timings[True][3] == sorted(str(i) for i in range(10000))
+for name, i in (('commit', 0), ('save', 1), ('open', 2)):
+    print(f'10000 python nodes {name}: per-item {timings[False][i]:.1f}ms, batched {timings[True][i]:.1f}ms')
+bigDoc = None
+
 print('----clean up---')
 doc = None
 xx = None
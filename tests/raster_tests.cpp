@@ -0,0 +1,91 @@
+#include <doctest/doctest.h>
+#include <nged/nged_raster.h>
+#include <nged/ngdoc.h>
+
+using namespace nged;
+
+// packed as 0xRRGGBBAA, like the colors in Canvas styles
+static uint32_t pixelAt(RasterCanvas const& canvas, int x, int y)
+{
+  auto const* p = canvas.pixels() + (size_t(y) * canvas.width() + x) * 4;
+  return uint32_t(p[0]) << 24 | uint32_t(p[1]) << 16 | uint32_t(p[2]) << 8 | uint32_t(p[3]);
+}
+
+TEST_CASE("Raster Canvas")
+{
+  RasterCanvas canvas(64, 64);
+  CHECK(canvas.width() == 64);
+  CHECK(canvas.height() == 64);
+
+  // canvas origin is the center of the image at scale 1
+  canvas.beginFrame(0x000000ff);
+  canvas.drawRect({-16, -16}, {16, 16}, 0.f, Canvas::ShapeStyle{true, 0xff0000ff, 0.f, 0});
+  canvas.drawCircle({20, 20}, 6.f, 0, Canvas::ShapeStyle{true, 0x00ff00ff, 0.f, 0});
+  canvas.endFrame();
+
+  uint32_t const red   = 0xff0000ff;
+  uint32_t const green = 0x00ff00ff;
+  uint32_t const black = 0x000000ff;
+  CHECK(pixelAt(canvas, 32, 32) == red);
+  CHECK(pixelAt(canvas, 20, 20) == red);
+  CHECK(pixelAt(canvas, 43, 43) == red);
+  CHECK(pixelAt(canvas, 52, 52) == green);
+  CHECK(pixelAt(canvas, 2, 2) == black);
+  CHECK(pixelAt(canvas, 32, 60) == black);
+  CHECK(pixelAt(canvas, 60, 32) == black);
+
+  // layers are composited in order, the upper layer wins
+  canvas.beginFrame(0x000000ff);
+  canvas.pushLayer(Canvas::Layer::Higher);
+  canvas.drawRect({-4, -4}, {4, 4}, 0.f, Canvas::ShapeStyle{true, 0x00ff00ff, 0.f, 0});
+  canvas.popLayer();
+  canvas.drawRect({-16, -16}, {16, 16}, 0.f, Canvas::ShapeStyle{true, 0xff0000ff, 0.f, 0});
+  canvas.endFrame();
+  CHECK(pixelAt(canvas, 32, 32) == green);
+  CHECK(pixelAt(canvas, 20, 20) == red);
+
+  auto const png = canvas.encodePNG();
+  REQUIRE(png.size() > 8);
+  CHECK(png[0] == 0x89);
+  CHECK(png[1] == 'P');
+  CHECK(png[2] == 'N');
+  CHECK(png[3] == 'G');
+}
+
+class RasterTestNodeFactory : public NodeFactory
+{
+  GraphPtr createRootGraph(NodeGraphDoc* root) const override
+  {
+    return std::make_shared<Graph>(root, nullptr, "root");
+  }
+  NodePtr createNode(Graph* parent, std::string_view type) const override
+  {
+    return std::make_shared<Node>(parent, String(type), String(type));
+  }
+  void listNodeTypes(
+    Graph* graph,
+    void*  context,
+    void (*ret)(void* context, StringView category, StringView type, StringView name))
+    const override
+  {
+    ret(context, "test", "null", "null");
+  }
+};
+
+TEST_CASE("Raster Canvas Draw Graph")
+{
+  auto         itemfactory = defaultGraphItemFactory();
+  NodeGraphDoc doc(std::make_shared<RasterTestNodeFactory>(), itemfactory.get());
+  doc.makeRoot();
+  auto node = doc.root()->createNode("null");
+  REQUIRE(node);
+  node->moveTo({1000, 500}); // far away from the canvas origin
+
+  RasterCanvas canvas(256, 128);
+  canvas.beginFrame(0x000000ff);
+  canvas.drawGraph(doc.root().get());
+  canvas.endFrame();
+  // the graph is fitted into the canvas, so the node covers the center
+  CHECK(pixelAt(canvas, 128, 64) != 0x000000ffu);
+  CHECK(pixelAt(canvas, 2, 2) == 0x000000ffu);
+}
@@ -197,11 +197,17 @@ target('ngdoc')
     'deps/parallel_hashmap/parallel_hashmap',
     {public=true})
 
+target('nged_raster')
+  set_kind('static')
+  add_headerfiles('include/nged/nged_raster.h')
+  add_files('src/nged_imgui_fonts.cpp', 'src/nged_raster.cpp')
+  add_deps('ngdoc', 'imgui')
+
 target('nged')
   set_kind('static')
-  add_headerfiles('include/nged/*.h|ngdoc.h')
-  add_files('src/nged.cpp', 'src/nged_imgui.cpp', 'src/nged_imgui_fonts.cpp')
-  add_deps('spdlog', 'nfd', 'imgui', 'boxer', 'ngdoc', 'entry')
+  add_headerfiles('include/nged/*.h|ngdoc.h|nged_raster.h')
+  add_files('src/nged.cpp', 'src/nged_imgui.cpp')
+  add_deps('spdlog', 'nfd', 'imgui', 'boxer', 'ngdoc', 'nged_raster', 'entry')
   add_cxflags('/bigobj', {tools='cl'})
   add_includedirs(
     'include',
@@ -213,12 +219,22 @@ target('nged')
 
 target('tests')
   set_kind('binary')
-  add_deps('ngdoc', 'spdlog')
-  add_files('tests/*.cpp')
+  add_deps('ngdoc', 'nged_raster', 'spdlog')
+  add_files('tests/*.cpp|parm_tests.cpp')
   add_includedirs(
     '.',
     'deps/doctest')
 
+target('nged_bench')
+  set_kind('binary')
+  add_deps('ngdoc', 'spdlog')
+  add_files('bench/graph_bench.cpp')
+
+target('nged_uibench')
+  set_kind('binary')
+  add_deps('nged', 'entry')
+  add_files('bench/ui_bench.cpp')
+
 target('lua')
   set_kind('static')
   add_includedirs('deps/lua')
@@ -293,6 +309,20 @@ if get_config('python') and get_config('python')~='no' then
     add_files('deps/parmscript/*.cpp')
     add_files('deps/parmscript/parmexpr.lua', {rule='utils.bin2c'})
 
+  target('parm_tests')
+    add_rules('pythonlib')
+    set_kind('binary')
+    add_deps('parmscript')
+    add_files('tests/main.cpp', 'tests/parm_tests.cpp')
+    add_includedirs('deps/doctest', 'deps/parmscript', 'deps/nlohmann')
+
+  target('nged_parmbench')
+    add_rules('pythonlib')
+    set_kind('binary')
+    add_deps('parmscript')
+    add_files('bench/parm_bench.cpp')
+    add_includedirs('deps/parmscript', 'deps/nlohmann')
+
   target('ngpy')
     add_rules('pythonlib')
     set_kind('shared')